@@ -20,6 +20,15 @@
 #define TEST_QFLOAT     "src/test/test_qfloat2.c"
 #define TEST_QFLOAT_EXE "test_qfloat.exe"
 
+#define TEST_QFLOAT_DD     "src/test/test_qfloat_dd.c"
+#define TEST_QFLOAT_DD_EXE "test_qfloat_dd.exe"
+
+#define TEST_UTILS     "src/test/test_utils.c"
+#define TEST_UTILS_EXE "test_utils.exe"
+
+#define TEST_MATH_EXACT     "src/test/test_math_exact.c"
+#define TEST_MATH_EXACT_EXE "test_math_exact.exe"
+
 void gen_float_tables();
 void build_lib_charconv();
 void run_tests();
@@ -83,11 +92,13 @@ void build_lib_charconv() {
   args_push(&args, "-O2");
   run_process("clang", &args);
 }
-void run_tests() {
+#define run_test(path, exe) run_test_impl(string(path), string(exe), string("./" exe))
+void run_test_impl(string path, string exe, string exe_path) {
   string *args = nil;
   // input
-  args_push(&args, TEST_QFLOAT);
-  args_push2(&args, "-o", TEST_QFLOAT_EXE);
+  array_push(&args, path);
+  args_push(&args, "-o");
+  array_push(&args, exe);
   // c standard
   set_c99(&args);
   // linker
@@ -110,5 +121,11 @@ void run_tests() {
   // TODO: delete .pdb, .rdi?
   run_process("clang", &args);
   // run
-  run_process("./" TEST_QFLOAT_EXE, 0);
+  run_process_impl(exe_path, 0);
+}
+void run_tests() {
+  run_test(TEST_QFLOAT, TEST_QFLOAT_EXE);
+  run_test(TEST_QFLOAT_DD, TEST_QFLOAT_DD_EXE);
+  run_test(TEST_UTILS, TEST_UTILS_EXE);
+  run_test(TEST_MATH_EXACT, TEST_MATH_EXACT_EXE);
 }
@@ -44,11 +44,127 @@ typedef struct {
   uint64_t high;
   uint64_t low;
 } qf_u128;
+#define QF_MAX_DIGITS_u64  20
+#define QF_MAX_DIGITS_u128 39
+qf_u128 qf_mul_u64(uint64_t a, uint64_t b) {
+  /* NOTE: a 64x64 -> 128 bit multiply compiles to a single `mul`, unlike 128-bit division */
+  unsigned __int128 product = (unsigned __int128)a * b;
+  return (qf_u128){(uint64_t)(product >> 64), (uint64_t)product};
+}
+/* NOTE: Improved division by invariant integers (Möller, Granlund 2011) https://gmplib.org/~tege/division-paper.pdf
+  divides `(high, low)` by a normalized `divisor` (top bit set) given `inverse = floor((2^128 - 1) / divisor) - 2^64`,
+  requires `high < divisor` */
+uint64_t qf_nonnull(5) qf_div_u128_u64_preinverted(uint64_t high, uint64_t low, uint64_t divisor, uint64_t inverse, uint64_t *restrict remainder) {
+  qf_u128 q = qf_mul_u64(inverse, high);
+  q.low += low;
+  q.high += high + 1 + (q.low < low);
+  uint64_t r = low - q.high * divisor;
+  if (r > q.low) {
+    q.high--;
+    r += divisor;
+  }
+  if (qf_far(r >= divisor)) {
+    q.high++;
+    r -= divisor;
+  }
+  *remainder = r;
+  return q.high;
+}
+
+// SWAR
+/* NOTE: SIMD Within A Register - check/parse 8 characters at a time */
+#define QF_SWAR (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+uint64_t qf_load_u64(const char *str) {
+  uint64_t chunk;
+  /* NOTE: `__builtin_memcpy()` still gets inlined with `-fno-builtin` */
+  __builtin_memcpy(&chunk, str, sizeof(chunk));
+  return chunk;
+}
+bool qf_is_8_decimal_digits(uint64_t chunk) {
+  return ((chunk & 0xF0F0F0F0F0F0F0F0) | (((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) == 0x3333333333333333;
+}
+uint64_t qf_parse_8_decimal_digits(uint64_t chunk) {
+  chunk -= 0x3030303030303030;
+  chunk = (chunk * 10) + (chunk >> 8);
+  chunk = (((chunk & 0x000000FF000000FF) * (100 + (1000000ULL << 32)))
+           + (((chunk >> 16) & 0x000000FF000000FF) * (1 + (10000ULL << 32))))
+          >> 32;
+  return chunk;
+}
+bool qf_is_8_hex_digits(uint64_t chunk) {
+  /* NOTE: for bytes `< 0x80`, `byte + (0x80 - c)` sets the high bit iff `byte >= c` */
+  uint64_t lower = chunk | 0x2020202020202020;
+  uint64_t is_decimal = (chunk + 0x5050505050505050) & ~(chunk + 0x4646464646464646);
+  uint64_t is_letter = (lower + 0x1F1F1F1F1F1F1F1F) & ~(lower + 0x1919191919191919);
+  bool is_ascii = (chunk & 0x8080808080808080) == 0;
+  return is_ascii && ((is_decimal | is_letter) & 0x8080808080808080) == 0x8080808080808080;
+}
+uint64_t qf_parse_8_hex_digits(uint64_t chunk) {
+  /* NOTE: '0'..'9' have bit 6 unset, 'A'..'F' and 'a'..'f' have bit 6 set and a low nibble of 1..6 */
+  chunk = (chunk & 0x0F0F0F0F0F0F0F0F) + ((chunk >> 6) & 0x0101010101010101) * 9;
+  chunk = __builtin_bswap64(chunk);
+  chunk = (chunk | (chunk >> 4)) & 0x00FF00FF00FF00FF;
+  chunk = (chunk | (chunk >> 8)) & 0x0000FFFF0000FFFF;
+  chunk = (chunk | (chunk >> 16)) & 0x00000000FFFFFFFF;
+  return chunk;
+}
 
 // parsing
-uint64_t qf_nonnull(1, 4) qf_parse_u64_decimal(const char *restrict str, intptr_t str_size, intptr_t start, intptr_t *restrict end) {
+/* NOTE: parse at most `max_digits` digits, without overflow checks */
+#define QF_MAX_SAFE_DIGITS_u64     19
+#define QF_MAX_SAFE_DIGITS_i64     18
+#define QF_MAX_SAFE_HEX_DIGITS_u64 16
+uint64_t qf_nonnull(1, 5) qf_parse_u64_decimal_digits(const char *restrict str, intptr_t str_size, intptr_t start, intptr_t max_digits, intptr_t *restrict end) {
+  qf_assert(max_digits <= QF_MAX_SAFE_DIGITS_u64);
   intptr_t i = start;
+  intptr_t i_end = qf_min(str_size, start + max_digits);
   uint64_t result = 0;
+#if QF_SWAR
+  while (i + 8 <= i_end) {
+    uint64_t chunk = qf_load_u64(&str[i]);
+    if (!qf_is_8_decimal_digits(chunk)) break;
+    result = result * 100000000 + qf_parse_8_decimal_digits(chunk);
+    i += 8;
+  }
+#endif
+  while (i < i_end) {
+    uint8_t digit = str[i] - '0';
+    if (digit >= 10) break;
+    result = result * 10 + digit;
+    i++;
+  }
+  *end = i;
+  return result;
+}
+uint64_t qf_nonnull(1, 5) qf_parse_u64_hex_digits(const char *restrict str, intptr_t str_size, intptr_t start, intptr_t max_digits, intptr_t *restrict end) {
+  qf_assert(max_digits <= QF_MAX_SAFE_HEX_DIGITS_u64);
+  intptr_t i = start;
+  intptr_t i_end = qf_min(str_size, start + max_digits);
+  uint64_t result = 0;
+#if QF_SWAR
+  while (i + 8 <= i_end) {
+    uint64_t chunk = qf_load_u64(&str[i]);
+    if (!qf_is_8_hex_digits(chunk)) break;
+    result = (result << 32) | qf_parse_8_hex_digits(chunk);
+    i += 8;
+  }
+#endif
+  while (i < i_end) {
+    char c = str[i];
+    uint8_t decimal = (uint8_t)(c - '0');
+    uint8_t hex = qf_min((uint8_t)(c - 'A'), (uint8_t)(c - 'a'));
+    uint64_t digit = decimal <= 9 ? decimal : hex + 10;
+    if (digit >= 16) break;
+    result = (result << 4) | digit;
+    i++;
+  }
+  *end = i;
+  return result;
+}
+uint64_t qf_nonnull(1, 4) qf_parse_u64_decimal(const char *restrict str, intptr_t str_size, intptr_t start, intptr_t *restrict end) {
+  intptr_t i;
+  uint64_t result = qf_parse_u64_decimal_digits(str, str_size, start, QF_MAX_SAFE_DIGITS_u64, &i);
+  // the rest can overflow
   while (i < str_size) {
     uint8_t digit = str[i] - '0';
     uint64_t new_result;
@@ -66,14 +182,16 @@ int64_t qf_nonnull(1, 4) qf_parse_i64_decimal(const char *restrict str, intptr_t
   bool negative = str[start] == '-';
   intptr_t i = negative || str[start] == '+' ? start + 1 : start;
   // value
-  int64_t result = 0;
+  uint64_t result_abs = qf_parse_u64_decimal_digits(str, str_size, i, QF_MAX_SAFE_DIGITS_i64, &i);
+  int64_t result = negative ? -(int64_t)result_abs : (int64_t)result_abs;
+  // the rest can overflow
   while (i < str_size) {
-    int8_t digit = str[i] - '0';
-    digit = negative ? -digit : digit;
+    uint8_t digit = str[i] - '0';
+    if (digit >= 10) break;
     int64_t new_result;
     bool did_overflow = __builtin_mul_overflow(result, 10, &new_result);
-    did_overflow |= __builtin_add_overflow(new_result, digit, &new_result);
-    if (digit >= 10 || did_overflow) break;
+    did_overflow |= __builtin_add_overflow(new_result, negative ? -(int64_t)digit : (int64_t)digit, &new_result);
+    if (did_overflow) break;
     result = new_result;
     i++;
   }
@@ -81,8 +199,9 @@ int64_t qf_nonnull(1, 4) qf_parse_i64_decimal(const char *restrict str, intptr_t
   return result;
 }
 uint64_t qf_nonnull(1, 4) qf_parse_u64_hex(const char *restrict str, intptr_t str_size, intptr_t start, intptr_t *restrict end) {
-  uint64_t result = 0;
-  intptr_t i = start;
+  intptr_t i;
+  uint64_t result = qf_parse_u64_hex_digits(str, str_size, start, QF_MAX_SAFE_HEX_DIGITS_u64, &i);
+  // the rest can overflow
   while (i < str_size) {
     uint64_t digit = 16;
     char c = str[i];
@@ -99,6 +218,124 @@ uint64_t qf_nonnull(1, 4) qf_parse_u64_hex(const char *restrict str, intptr_t st
   *end = i;
   return result;
 }
+// fixed-width parsing
+/* NOTE: parse exactly `width` digits, without termination or overflow checks,
+  `width` is a compile-time constant in the kernels below, so the loops fully unroll */
+#define QF_MAX_FIXED_WIDTH_u64 QF_MAX_SAFE_DIGITS_u64
+#define QF_FIXED_WIDTHS_u64(X) \
+  X(1) X(2) X(3) X(4) X(5) X(6) X(7) X(8) X(9) X(10) X(11) X(12) X(13) X(14) X(15) X(16) X(17) X(18) X(19)
+static inline __attribute__((always_inline)) uint64_t qf_parse_u64_fixed_width(const char *restrict str, intptr_t width, bool *restrict invalid) {
+  uint64_t result = 0;
+  intptr_t i = 0;
+#if QF_SWAR
+  for (; i + 8 <= width; i += 8) {
+    uint64_t chunk = qf_load_u64(&str[i]);
+    *invalid |= !qf_is_8_decimal_digits(chunk);
+    result = result * 100000000 + qf_parse_8_decimal_digits(chunk);
+  }
+#endif
+  for (; i < width; i++) {
+    uint8_t digit = str[i] - '0';
+    *invalid |= digit >= 10;
+    result = result * 10 + digit;
+  }
+  return result;
+}
+/* NOTE: qf_parse_u64_column_N(): parse `count` fields of width N at `start + k*stride`,
+  returns false if any field contained a non-digit */
+#define QF_PARSE_U64_COLUMN(width)                                                                                                                       \
+  bool qf_nonnull(1, 5) qf_parse_u64_column_##width(const char *restrict str, intptr_t start, intptr_t stride, intptr_t count, uint64_t *restrict out) { \
+    bool invalid = false;                                                                                                                                \
+    for (intptr_t k = 0; k < count; k++) {                                                                                                               \
+      out[k] = qf_parse_u64_fixed_width(&str[start + k * stride], width, &invalid);                                                                      \
+    }                                                                                                                                                    \
+    return !invalid;                                                                                                                                     \
+  }
+QF_FIXED_WIDTHS_u64(QF_PARSE_U64_COLUMN)
+bool qf_nonnull(1, 6) qf_parse_u64_column(const char *restrict str, intptr_t start, intptr_t stride, intptr_t width, intptr_t count, uint64_t *restrict out) {
+  switch (width) {
+#define QF_PARSE_U64_COLUMN_CASE(width) \
+  case width:                           \
+    return qf_parse_u64_column_##width(str, start, stride, count, out);
+    QF_FIXED_WIDTHS_u64(QF_PARSE_U64_COLUMN_CASE)
+#undef QF_PARSE_U64_COLUMN_CASE
+  default:
+    qf_assert(false && "width must be in [1, QF_MAX_FIXED_WIDTH_u64]");
+    return false;
+  }
+}
+typedef struct {
+  intptr_t offset;
+  intptr_t width;
+} qf_field;
+/* NOTE: parse `count` fields at arbitrary offsets/widths, returns false if any field contained a non-digit */
+bool qf_nonnull(1, 2, 4) qf_parse_u64_fields(const char *restrict str, const qf_field *restrict fields, intptr_t count, uint64_t *restrict out) {
+  bool invalid = false;
+  for (intptr_t k = 0; k < count; k++) {
+    qf_field field = fields[k];
+    switch (field.width) {
+#define QF_PARSE_U64_FIELD_CASE(width)                                      \
+  case width:                                                               \
+    out[k] = qf_parse_u64_fixed_width(&str[field.offset], width, &invalid); \
+    break;
+      QF_FIXED_WIDTHS_u64(QF_PARSE_U64_FIELD_CASE)
+#undef QF_PARSE_U64_FIELD_CASE
+    default:
+      qf_assert(false && "width must be in [1, QF_MAX_FIXED_WIDTH_u64]");
+      return false;
+    }
+  }
+  return !invalid;
+}
+// 128-bit parsing
+const uint64_t QF_POWERS_OF_10_u64[QF_MAX_DIGITS_u64] = {
+  1ULL,
+  10ULL,
+  100ULL,
+  1000ULL,
+  10000ULL,
+  100000ULL,
+  1000000ULL,
+  10000000ULL,
+  100000000ULL,
+  1000000000ULL,
+  10000000000ULL,
+  100000000000ULL,
+  1000000000000ULL,
+  10000000000000ULL,
+  100000000000000ULL,
+  1000000000000000ULL,
+  10000000000000000ULL,
+  100000000000000000ULL,
+  1000000000000000000ULL,
+  10000000000000000000ULL,
+};
+qf_u128 qf_nonnull(1, 4) qf_parse_u128_decimal(const char *restrict str, intptr_t str_size, intptr_t start, intptr_t *restrict end) {
+  // the first 38 digits can't overflow
+  intptr_t i;
+  uint64_t high_digits = qf_parse_u64_decimal_digits(str, str_size, start, QF_MAX_SAFE_DIGITS_u64, &i);
+  intptr_t low_start = i;
+  uint64_t low_digits = qf_parse_u64_decimal_digits(str, str_size, low_start, QF_MAX_SAFE_DIGITS_u64, &i);
+  qf_u128 result = qf_mul_u64(high_digits, QF_POWERS_OF_10_u64[i - low_start]);
+  result.low += low_digits;
+  result.high += result.low < low_digits;
+  // the rest can overflow
+  while (i < str_size) {
+    uint8_t digit = str[i] - '0';
+    if (digit >= 10) break;
+    qf_u128 new_result = qf_mul_u64(result.low, 10);
+    uint64_t high_times_10;
+    bool did_overflow = __builtin_mul_overflow(result.high, 10, &high_times_10);
+    did_overflow |= __builtin_add_overflow(new_result.high, high_times_10, &new_result.high);
+    new_result.low += digit;
+    did_overflow |= __builtin_add_overflow(new_result.high, (uint64_t)(new_result.low < digit), &new_result.high);
+    if (did_overflow) break;
+    result = new_result;
+    i++;
+  }
+  *end = i;
+  return result;
+}
 uint64_t qf_nonnull(1, 4, 5) qf_parse_f64_significand(const char *restrict str, intptr_t str_size, intptr_t start, intptr_t *restrict end, int32_t *restrict exponent_10_ptr) {
   uint64_t significand_10 = 0;
   intptr_t i = start;
@@ -225,6 +462,55 @@ qf_f64 qf_parse_f64(const char *restrict str, intptr_t str_size, intptr_t start,
 }
 
 // formatting
+const char QF_DIGIT_PAIRS[200] = "00010203040506070809101112131415161718192021222324252627282930313233343536373839404142434445464748495051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+/* NOTE: write `value` backwards from `buffer_end`, zero-padded to at least `min_digits` */
+intptr_t qf_nonnull(1) qf_format_u64_backwards(char *buffer_end, uint64_t value, intptr_t min_digits) {
+  char *ptr = buffer_end;
+  while (value >= 100) {
+    uint64_t pair = value % 100;
+    value /= 100;
+    ptr -= 2;
+    __builtin_memcpy(ptr, &QF_DIGIT_PAIRS[pair * 2], 2);
+  }
+  if (value >= 10) {
+    ptr -= 2;
+    __builtin_memcpy(ptr, &QF_DIGIT_PAIRS[value * 2], 2);
+  } else {
+    *--ptr = (char)('0' + value);
+  }
+  while (buffer_end - ptr < min_digits) {
+    *--ptr = '0';
+  }
+  return buffer_end - ptr;
+}
+/* NOTE: 10^19 is the largest power of 10 that fits in a u64, and it happens to be normalized */
+#define QF_10_POW_19         10000000000000000000ULL
+#define QF_10_POW_19_INVERSE 0xd83c94fb6d2ac34aULL
+/* NOTE: write `value` into `buffer` (not null-terminated), returns the number of digits */
+intptr_t qf_nonnull(1) qf_format_u128_decimal(char buffer[restrict QF_MAX_DIGITS_u128], qf_u128 value) {
+  char digits[QF_MAX_DIGITS_u128];
+  char *digits_end = &digits[QF_MAX_DIGITS_u128];
+  intptr_t size;
+  if (value.high == 0) {
+    size = qf_format_u64_backwards(digits_end, value.low, 1);
+  } else {
+    /* NOTE: split into 19 digit chunks, `value < 2^128 < 10^39` so there are at most 3 */
+    uint64_t chunk_0, chunk_1;
+    uint64_t quotient_high = value.high / QF_10_POW_19;
+    uint64_t remainder_high = value.high % QF_10_POW_19;
+    uint64_t quotient_low = qf_div_u128_u64_preinverted(remainder_high, value.low, QF_10_POW_19, QF_10_POW_19_INVERSE, &chunk_0);
+    uint64_t top = qf_div_u128_u64_preinverted(quotient_high, quotient_low, QF_10_POW_19, QF_10_POW_19_INVERSE, &chunk_1);
+    size = qf_format_u64_backwards(digits_end, chunk_0, QF_MAX_SAFE_DIGITS_u64);
+    if (top == 0) {
+      size += qf_format_u64_backwards(digits_end - size, chunk_1, 1);
+    } else {
+      size += qf_format_u64_backwards(digits_end - size, chunk_1, QF_MAX_SAFE_DIGITS_u64);
+      size += qf_format_u64_backwards(digits_end - size, top, 1);
+    }
+  }
+  __builtin_memcpy(buffer, digits_end - size, (size_t)size);
+  return size;
+}
 void format_f64(char buffer[restrict 30], qf_f64 value) {
   // TODO: dragonbox
   uint64_t value_u64;
@@ -0,0 +1,216 @@
+// https://github.com/Patrolin/qfloat
+#pragma once
+#include "qfloat.h"
+
+/* NOTE: arrays of double-doubles, `QFLOAT_DD_LANES` at a time
+  https://www.davidhbailey.com/dhbpapers/qd.pdf
+  Accurate Sum and Dot Product (Ogita, Rump, Oishi 2005) https://www.tuhh.de/ti3/paper/rump/OgRuOi05.pdf */
+#if __AVX512F__
+  #define QFLOAT_DD_LANES 8
+#else
+  #define QFLOAT_DD_LANES 4
+#endif
+/* NOTE: `aligned(8)` so we can load straight from (unaligned) user arrays */
+typedef qfloat_f64 qfloat_f64xN __attribute__((__vector_size__(QFLOAT_DD_LANES * sizeof(qfloat_f64)), __aligned__(sizeof(qfloat_f64))));
+typedef qfloat_i64 qfloat_i64xN __attribute__((__vector_size__(QFLOAT_DD_LANES * sizeof(qfloat_i64)), __aligned__(sizeof(qfloat_i64))));
+typedef struct {
+  qfloat_f64xN high;
+  qfloat_f64xN low;
+} qfloat_ddxN;
+/* NOTE: struct of arrays, so that highs and lows can be loaded separately */
+typedef struct {
+  qfloat_f64 *_Nonnull high;
+  qfloat_f64 *_Nonnull low;
+} qfloat_dd_array;
+
+#pragma STDC FENV_ACCESS ON
+#if __has_builtin(__builtin_elementwise_fma)
+  #define qfloat_fma_f64xN(a, b, c) __builtin_elementwise_fma(a, b, c)
+#else
+inline __attribute__((always_inline)) qfloat_f64xN qfloat_fma_f64xN(qfloat_f64xN a, qfloat_f64xN b, qfloat_f64xN c) {
+  qfloat_f64xN result;
+  for (int j = 0; j < QFLOAT_DD_LANES; j++) {
+    result[j] = qfloat_fma_f64(a[j], b[j], c[j]);
+  }
+  return result;
+}
+#endif
+#if __has_builtin(__builtin_elementwise_sqrt)
+  #define qfloat_sqrt_f64xN(a) __builtin_elementwise_sqrt(a)
+#else
+inline __attribute__((always_inline)) qfloat_f64xN qfloat_sqrt_f64xN(qfloat_f64xN a) {
+  qfloat_f64xN result;
+  for (int j = 0; j < QFLOAT_DD_LANES; j++) {
+    result[j] = __builtin_sqrt(a[j]);
+  }
+  return result;
+}
+#endif
+
+// load/store
+#define qfloat_load_f64xN(ptr) (*(const qfloat_f64xN *)(ptr))
+#define qfloat_load_ddxN(array, i) \
+  ((qfloat_ddxN){qfloat_load_f64xN(&(array).high[i]), qfloat_load_f64xN(&(array).low[i])})
+#define qfloat_store_ddxN(array, i, value)              \
+  do {                                                  \
+    *(qfloat_f64xN *)(&(array).high[i]) = (value).high; \
+    *(qfloat_f64xN *)(&(array).low[i]) = (value).low;   \
+  } while (0)
+/* NOTE: pad the tail with zeros, so that the tail can go through the same kernels */
+inline __attribute__((always_inline)) qfloat_f64xN qfloat_load_tail_f64xN(const qfloat_f64 *_Nonnull ptr, qfloat_iptr count) {
+  qfloat_f64xN result = {};
+  for (qfloat_iptr j = 0; j < count; j++) {
+    result[j] = ptr[j];
+  }
+  return result;
+}
+inline __attribute__((always_inline)) qfloat_ddxN qfloat_load_tail_ddxN(qfloat_dd_array array, qfloat_iptr i, qfloat_iptr count) {
+  return (qfloat_ddxN){qfloat_load_tail_f64xN(&array.high[i], count), qfloat_load_tail_f64xN(&array.low[i], count)};
+}
+inline __attribute__((always_inline)) void qfloat_store_tail_ddxN(qfloat_dd_array array, qfloat_iptr i, qfloat_iptr count, qfloat_ddxN value) {
+  for (qfloat_iptr j = 0; j < count; j++) {
+    array.high[i + j] = value.high[j];
+    array.low[i + j] = value.low[j];
+  }
+}
+
+// error-free transforms
+/* NOTE: `high + low == a + b` exactly */
+inline __attribute__((always_inline)) qfloat_ddxN qfloat_two_sum_f64xN(qfloat_f64xN a, qfloat_f64xN b) {
+  qfloat_f64xN result = a + b;
+  qfloat_f64xN b_virtual = result - a;
+  qfloat_f64xN error = (a - (result - b_virtual)) + (b - b_virtual);
+  return (qfloat_ddxN){result, error};
+}
+/* NOTE: same as qfloat_two_sum_f64xN(), but requires `abs(a) >= abs(b)` */
+inline __attribute__((always_inline)) qfloat_ddxN qfloat_fast_two_sum_f64xN(qfloat_f64xN a, qfloat_f64xN b) {
+  qfloat_f64xN result = a + b;
+  qfloat_f64xN error = b - (result - a);
+  return (qfloat_ddxN){result, error};
+}
+
+// arithmetic
+inline __attribute__((always_inline)) qfloat_ddxN augmented_add_ddxN(qfloat_ddxN a, qfloat_ddxN b) {
+  qfloat_ddxN high = qfloat_two_sum_f64xN(a.high, b.high);
+  qfloat_ddxN low = qfloat_two_sum_f64xN(a.low, b.low);
+  qfloat_ddxN result = qfloat_fast_two_sum_f64xN(high.high, high.low + low.high);
+  return qfloat_fast_two_sum_f64xN(result.high, result.low + low.low);
+}
+inline __attribute__((always_inline)) qfloat_ddxN augmented_mul_ddxN(qfloat_ddxN a, qfloat_ddxN b) {
+  qfloat_f64xN result = a.high * b.high;
+  qfloat_f64xN error = qfloat_fma_f64xN(a.high, b.high, -result) + (a.high * b.low + a.low * b.high);
+  return qfloat_fast_two_sum_f64xN(result, error);
+}
+inline __attribute__((always_inline)) qfloat_ddxN augmented_div_ddxN(qfloat_ddxN a, qfloat_ddxN b) {
+  qfloat_f64xN result = a.high / b.high;
+  qfloat_f64xN error = (qfloat_fma_f64xN(-result, b.high, a.high) + a.low - result * b.low) / b.high;
+  return qfloat_fast_two_sum_f64xN(result, error);
+}
+inline __attribute__((always_inline)) qfloat_ddxN augmented_sqrt_ddxN(qfloat_ddxN a) {
+  qfloat_f64xN result = qfloat_sqrt_f64xN(a.high);
+  qfloat_f64xN error = (qfloat_fma_f64xN(-result, result, a.high) + a.low) / (result + result);
+  /* NOTE: `sqrt(0)` would give `0/0` */
+  qfloat_i64xN is_zero = a.high == 0.0;
+  error = (qfloat_f64xN)((qfloat_i64xN)error & ~is_zero);
+  return qfloat_fast_two_sum_f64xN(result, error);
+}
+/* NOTE: horizontal add in lane order, so results don't depend on the register width of the caller */
+qfloat_dd qfloat_reduce_ddxN(qfloat_ddxN value) {
+  qfloat_dd result = {0.0, 0.0};
+  for (int j = 0; j < QFLOAT_DD_LANES; j++) {
+    result = augmented_add_dd(result, (qfloat_dd){value.high[j], value.low[j]});
+  }
+  return result;
+}
+
+// array arithmetic
+#define QFLOAT_DD_ARRAY_OP(name, kernel)                                                                            \
+  void name(qfloat_dd_array result, qfloat_dd_array a, qfloat_dd_array b, qfloat_iptr count) {                    \
+    qfloat_iptr i = 0;                                                                                            \
+    for (; i + QFLOAT_DD_LANES <= count; i += QFLOAT_DD_LANES) {                                                  \
+      qfloat_store_ddxN(result, i, kernel(qfloat_load_ddxN(a, i), qfloat_load_ddxN(b, i)));                       \
+    }                                                                                                             \
+    if (i < count) {                                                                                              \
+      qfloat_ddxN value = kernel(qfloat_load_tail_ddxN(a, i, count - i), qfloat_load_tail_ddxN(b, i, count - i)); \
+      qfloat_store_tail_ddxN(result, i, count - i, value);                                                        \
+    }                                                                                                             \
+  }
+/* NOTE: `result[i] = a[i] op b[i]`, `result` may alias `a` or `b` */
+QFLOAT_DD_ARRAY_OP(qfloat_dd_add_array, augmented_add_ddxN)
+QFLOAT_DD_ARRAY_OP(qfloat_dd_mul_array, augmented_mul_ddxN)
+QFLOAT_DD_ARRAY_OP(qfloat_dd_div_array, augmented_div_ddxN)
+void qfloat_dd_sqrt_array(qfloat_dd_array result, qfloat_dd_array a, qfloat_iptr count) {
+  qfloat_iptr i = 0;
+  for (; i + QFLOAT_DD_LANES <= count; i += QFLOAT_DD_LANES) {
+    qfloat_store_ddxN(result, i, augmented_sqrt_ddxN(qfloat_load_ddxN(a, i)));
+  }
+  if (i < count) {
+    qfloat_ddxN value = augmented_sqrt_ddxN(qfloat_load_tail_ddxN(a, i, count - i));
+    qfloat_store_tail_ddxN(result, i, count - i, value);
+  }
+}
+
+// reductions
+/* NOTE: Sum2, as accurate as summing in double-double and then rounding to f64 */
+qfloat_dd qfloat_sum_f64(const qfloat_f64 *_Nonnull values, qfloat_iptr count) {
+  /* NOTE: two independent accumulators, to hide the latency of qfloat_two_sum_f64xN() */
+  qfloat_ddxN sum0 = {};
+  qfloat_ddxN sum1 = {};
+  qfloat_iptr i = 0;
+  for (; i + 2 * QFLOAT_DD_LANES <= count; i += 2 * QFLOAT_DD_LANES) {
+    qfloat_ddxN next0 = qfloat_two_sum_f64xN(sum0.high, qfloat_load_f64xN(&values[i]));
+    qfloat_ddxN next1 = qfloat_two_sum_f64xN(sum1.high, qfloat_load_f64xN(&values[i + QFLOAT_DD_LANES]));
+    sum0 = (qfloat_ddxN){next0.high, sum0.low + next0.low};
+    sum1 = (qfloat_ddxN){next1.high, sum1.low + next1.low};
+  }
+  for (; i < count; i += QFLOAT_DD_LANES) {
+    qfloat_iptr lanes = count - i < QFLOAT_DD_LANES ? count - i : QFLOAT_DD_LANES;
+    qfloat_ddxN next0 = qfloat_two_sum_f64xN(sum0.high, qfloat_load_tail_f64xN(&values[i], lanes));
+    sum0 = (qfloat_ddxN){next0.high, sum0.low + next0.low};
+  }
+  return augmented_add_dd(qfloat_reduce_ddxN(sum0), qfloat_reduce_ddxN(sum1));
+}
+/* NOTE: Dot2, as accurate as computing in double-double and then rounding to f64 */
+qfloat_dd qfloat_dot_f64(const qfloat_f64 *_Nonnull a, const qfloat_f64 *_Nonnull b, qfloat_iptr count) {
+  qfloat_ddxN sum = {};
+  for (qfloat_iptr i = 0; i < count; i += QFLOAT_DD_LANES) {
+    qfloat_f64xN a_i, b_i;
+    if (__builtin_expect(i + QFLOAT_DD_LANES <= count, true)) {
+      a_i = qfloat_load_f64xN(&a[i]);
+      b_i = qfloat_load_f64xN(&b[i]);
+    } else {
+      a_i = qfloat_load_tail_f64xN(&a[i], count - i);
+      b_i = qfloat_load_tail_f64xN(&b[i], count - i);
+    }
+    qfloat_f64xN product = a_i * b_i;
+    qfloat_f64xN product_error = qfloat_fma_f64xN(a_i, b_i, -product);
+    qfloat_ddxN next = qfloat_two_sum_f64xN(sum.high, product);
+    sum = (qfloat_ddxN){next.high, sum.low + (next.low + product_error)};
+  }
+  return qfloat_reduce_ddxN(sum);
+}
+qfloat_dd qfloat_dd_sum(qfloat_dd_array values, qfloat_iptr count) {
+  qfloat_ddxN sum = {};
+  for (qfloat_iptr i = 0; i < count; i += QFLOAT_DD_LANES) {
+    qfloat_ddxN value = i + QFLOAT_DD_LANES <= count ? qfloat_load_ddxN(values, i) : qfloat_load_tail_ddxN(values, i, count - i);
+    sum = augmented_add_ddxN(sum, value);
+  }
+  return qfloat_reduce_ddxN(sum);
+}
+qfloat_dd qfloat_dd_dot(qfloat_dd_array a, qfloat_dd_array b, qfloat_iptr count) {
+  qfloat_ddxN sum = {};
+  for (qfloat_iptr i = 0; i < count; i += QFLOAT_DD_LANES) {
+    qfloat_ddxN a_i, b_i;
+    if (__builtin_expect(i + QFLOAT_DD_LANES <= count, true)) {
+      a_i = qfloat_load_ddxN(a, i);
+      b_i = qfloat_load_ddxN(b, i);
+    } else {
+      a_i = qfloat_load_tail_ddxN(a, i, count - i);
+      b_i = qfloat_load_tail_ddxN(b, i, count - i);
+    }
+    sum = augmented_add_ddxN(sum, augmented_mul_ddxN(a_i, b_i));
+  }
+  return qfloat_reduce_ddxN(sum);
+}
+/* NOTE: overwrite FENV_ACCESS pragma to default value */
+#pragma STDC FENV_ACCESS DEFAULT
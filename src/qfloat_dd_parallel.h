@@ -0,0 +1,32 @@
+// https://github.com/Patrolin/qfloat
+#pragma once
+#include "utils/threads.h"
+#if NOLIBC
+  #define QFLOAT_NOLIBC                1
+  #define qfloat_copy(ptr, size, dest) memcpy(dest, ptr, size)
+#endif
+#define qfloat_assert(condition) assert(condition)
+#include "qfloat_dd.h"
+
+/* sum `values` across all threads in the current group, every thread gets the same result
+  NOTE: the partial sums are combined in thread order, so the result doesn't depend on timing */
+qfloat_dd qfloat_parallel_sum_f64(Thread t, const qfloat_f64 *_Nonnull values, qfloat_iptr count) {
+  Thread threads_start = global_threads.thread_infos[t].threads_start;
+  Thread threads_end = global_threads.thread_infos[t].threads_end;
+  qfloat_iptr thread_count = (qfloat_iptr)(threads_end - threads_start);
+  // sum our part
+  /* NOTE: round up to a multiple of QFLOAT_DD_LANES, so that only the last part has a tail */
+  qfloat_iptr part_size = (count + thread_count - 1) / thread_count;
+  part_size = align_up(part_size, QFLOAT_DD_LANES - 1);
+  qfloat_iptr start = min(count, (qfloat_iptr)(t - threads_start) * part_size);
+  qfloat_iptr end = min(count, start + part_size);
+  qfloat_dd partial = qfloat_sum_f64(values + start, end - start);
+  // combine parts
+  u64 *partials = barrier_gather(t, &partial);
+  qfloat_dd result = {0.0, 0.0};
+  for (Thread i = threads_start; i < threads_end; i++) {
+    result = augmented_add_dd(result, *(qfloat_dd *)partials[i]);
+  }
+  barrier(t); /* NOTE: make sure all threads have read the partials */
+  return result;
+}
@@ -0,0 +1,842 @@
+// clang build.c -o build.exe && ./build.exe
+#include "../utils/math_exact.h"
+#include "../utils/entry.h"
+#include "../utils/tests.h"
+
+// params
+#define TEST_SCRATCH_SIZE (usize(1) << 30)
+
+// helpers
+/* NOTE: random chunks, with zero and all-ones chunks mixed in to hit the carry edge cases */
+void test_random_integer(u64 *state, Integer a) {
+  for (usize i = 0; i < a.chunks_size; i++) {
+    u64 chunk = test_random(state);
+    u64 kind = test_random(state) % 8;
+    if (kind == 0) {
+      chunk = 0;
+    } else if (kind == 1) {
+      chunk = MAX_u64;
+    } else if (kind == 2) {
+      chunk >>= test_random(state) % 64;
+    }
+    a.chunks[i] = chunk;
+  }
+}
+/* NOTE: compares the values, sign extending the shorter one */
+bool test_integer_equals(Integer a, Integer b) {
+  u64 extension_a = integer_sign_extension(a);
+  u64 extension_b = integer_sign_extension(b);
+  usize chunks_size = max(a.chunks_size, b.chunks_size);
+  for (usize i = 0; i < chunks_size; i++) {
+    if (integer_get_chunk(a, i, extension_a) != integer_get_chunk(b, i, extension_b)) return false;
+  }
+  return true;
+}
+bool test_integer_equals_u128(Integer a, u128 b) {
+  u64 b_chunks[3] = {u64(b), u64(b >> 64), 0};
+  return test_integer_equals(a, (Integer){b_chunks, 3});
+}
+bool test_integer_is_zero(Integer a) {
+  return _integer_unsigned_size(a) == 0;
+}
+/* NOTE: `a = quotient * b + remainder`, `abs(remainder) < abs(b)`, and `remainder` has the sign of `a` */
+bool test_div_is_correct(Arena *scratch, Integer a, Integer b, Integer quotient, Integer remainder) {
+  bool is_correct;
+  with_arena(scratch) {
+    Integer product = integer_arena_alloc(scratch, integer_mul_size(quotient, b));
+    integer_mul(scratch, &product, quotient, b);
+    Integer sum = integer_arena_alloc(scratch, integer_add_size(product, remainder));
+    integer_add(&sum, product, remainder);
+    Integer remainder_abs = integer_arena_alloc(scratch, integer_negate_size(remainder));
+    if (integer_sign_extension(remainder) != 0) {
+      integer_negate(&remainder_abs, remainder);
+    } else {
+      integer_copy(&remainder_abs, remainder);
+    }
+    Integer b_abs = integer_arena_alloc(scratch, integer_negate_size(b));
+    if (integer_sign_extension(b) != 0) {
+      integer_negate(&b_abs, b);
+    } else {
+      integer_copy(&b_abs, b);
+    }
+    bool is_same_sign = test_integer_is_zero(remainder) || integer_sign_extension(remainder) == integer_sign_extension(a);
+    is_correct = test_integer_equals(sum, a) && _integer_compare_unsigned(remainder_abs, b_abs) < 0 && is_same_sign;
+  }
+  return is_correct;
+}
+/* NOTE: reference product, `abs(a) * abs(b)` with schoolbook, then the sign */
+void test_mul_schoolbook(Arena *scratch, Integer *result, Integer a, Integer b) {
+  with_arena(scratch) {
+    Integer a_abs = integer_arena_alloc(scratch, integer_negate_size(a));
+    if (integer_sign_extension(a) != 0) {
+      integer_negate(&a_abs, a);
+    } else {
+      integer_copy(&a_abs, a);
+    }
+    Integer b_abs = integer_arena_alloc(scratch, integer_negate_size(b));
+    if (integer_sign_extension(b) != 0) {
+      integer_negate(&b_abs, b);
+    } else {
+      integer_copy(&b_abs, b);
+    }
+    Integer product = integer_arena_alloc(scratch, a_abs.chunks_size + b_abs.chunks_size);
+    _integer_mul_schoolbook_unsigned(product, a_abs, b_abs);
+    if (integer_sign_extension(a) != integer_sign_extension(b)) {
+      integer_negate(result, product);
+    } else {
+      integer_copy(result, product);
+    }
+  }
+}
+/* NOTE: `integer_mul(a, b) == test_mul_schoolbook(a, b)` */
+bool test_mul_is_correct(Arena *scratch, Integer a, Integer b) {
+  bool is_correct;
+  with_arena(scratch) {
+    Integer product = integer_arena_alloc(scratch, integer_mul_size(a, b));
+    integer_mul(scratch, &product, a, b);
+    Integer expected = integer_arena_alloc(scratch, integer_mul_size(a, b));
+    test_mul_schoolbook(scratch, &expected, a, b);
+    is_correct = test_integer_equals(product, expected);
+  }
+  return is_correct;
+}
+/* NOTE: `mul(result, a, b)` on unsigned operands equals _integer_mul_schoolbook_unsigned(), where `result` has `a.chunks_size + b.chunks_size` chunks */
+typedef void TestMulUnsignedProc(Arena *scratch, Integer result, Integer a, Integer b);
+bool test_mul_unsigned_is_correct(Arena *scratch, TestMulUnsignedProc *mul, Integer a, Integer b) {
+  bool is_correct;
+  with_arena(scratch) {
+    Integer product = integer_arena_alloc(scratch, a.chunks_size + b.chunks_size);
+    mul(scratch, product, a, b);
+    Integer expected = integer_arena_alloc(scratch, a.chunks_size + b.chunks_size);
+    _integer_mul_schoolbook_unsigned(expected, a, b);
+    is_correct = _integer_compare_unsigned(product, expected) == 0;
+  }
+  return is_correct;
+}
+/* NOTE: bit `i` of `a`, or of `extension` past the end */
+u64 test_integer_bit(Integer a, usize i, u64 extension) {
+  return (integer_get_chunk(a, i / 64, extension) >> (i % 64)) & 1;
+}
+/* NOTE: random decimal digits, with runs of zeros */
+void test_random_digits(u64 *state, byte *digits, usize digits_size) {
+  usize i = 0;
+  while (i < digits_size) {
+    usize run_size = min(usize(test_random(state) % 64) + 1, digits_size - i);
+    bool is_zeros = test_random(state) % 4 == 0;
+    for (usize j = 0; j < run_size; j++) {
+      digits[i++] = is_zeros ? '0' : byte('0' + test_random(state) % 10);
+    }
+  }
+}
+
+void thread_main(Thread t) {
+  Arena scratch = arena_init(TEST_SCRATCH_SIZE);
+  TestGroup *group;
+  // test _u64_reciprocal(), _u128_div_u64_preinverted()
+  if (test_group(t, &group, string("_u128_div_u64_preinverted()"), 1)) {
+    u64 state = 0x8CB92BA72F3D8DD7;
+    for (iptr i = 0; i < 100000; i++) {
+      u64 divisor = test_random(&state) | (u64(1) << 63);
+      if (i < 2) divisor = i == 0 ? u64(1) << 63 : MAX_u64;
+      u64 reciprocal = _u64_reciprocal(divisor);
+      check(t, group, reciprocal == u64(~u128(0) / divisor - (u128(1) << 64)), u64, divisor);
+      u64 high = test_random(&state) % divisor;
+      u64 low = test_random(&state);
+      if (i % 4 == 0) high = divisor - 1;
+      if (i % 8 == 0) low = MAX_u64;
+      u128 a = (u128(high) << 64) | low;
+      u64 remainder;
+      u64 quotient = _u128_div_u64_preinverted(high, low, divisor, reciprocal, &remainder);
+      check(t, group, quotient == u64(a / divisor) && remainder == u64(a % divisor), u64, divisor);
+    }
+  }
+  test_summary(t, group);
+  // test integer_div_u64()
+  if (test_group(t, &group, string("integer_div_u64()"), 1)) {
+    u64 state = 0x3C6EF372FE94F82B;
+    for (iptr i = 0; i < 100000; i++) {
+      u64 a_chunks[2];
+      Integer a = (Integer){a_chunks, 2};
+      test_random_integer(&state, a);
+      u64 divisor = test_random(&state) >> (test_random(&state) % 64);
+      if (divisor == 0) divisor = 1;
+      u128 a_u128 = (u128(a_chunks[1]) << 64) | a_chunks[0];
+      /* NOTE: the quotient is unsigned, so give it a zero chunk on top */
+      u64 quotient_chunks[3];
+      Integer quotient = (Integer){quotient_chunks, integer_div_u64_size(a) + 1};
+      u64 remainder = integer_div_u64(&quotient, a, divisor);
+      check(t, group, test_integer_equals_u128(quotient, a_u128 / divisor), u64, divisor);
+      check(t, group, remainder == u64(a_u128 % divisor), u64, divisor);
+      /* NOTE: `quotient` may alias `a` */
+      remainder = integer_div_u64(&a, a, divisor);
+      check(t, group, a_chunks[0] == quotient_chunks[0] && a_chunks[1] == quotient_chunks[1], u64, divisor);
+      check(t, group, remainder == u64(a_u128 % divisor), u64, divisor);
+    }
+  }
+  test_summary(t, group);
+  // test integer_div()
+  if (test_group(t, &group, string("integer_div()"), 1)) {
+    // small operands
+    u64 state = 0xA54FF53A5F1D36F1;
+    for (iptr i = 0; i < 100000; i++) {
+      /* NOTE: non-negative, so we can compare with u128 division */
+      u64 a_chunks[3] = {test_random(&state), test_random(&state) >> (test_random(&state) % 65), 0};
+      u64 b_chunks[3] = {test_random(&state) >> (test_random(&state) % 64), i % 2 == 0 ? 0 : test_random(&state) >> (test_random(&state) % 64), 0};
+      if (b_chunks[0] == 0 && b_chunks[1] == 0) b_chunks[0] = 1;
+      Integer a = (Integer){a_chunks, 3};
+      Integer b = (Integer){b_chunks, 3};
+      u128 a_u128 = (u128(a_chunks[1]) << 64) | a_chunks[0];
+      u128 b_u128 = (u128(b_chunks[1]) << 64) | b_chunks[0];
+      with_arena(&scratch) {
+        Integer quotient = integer_arena_alloc(&scratch, integer_div_quotient_size(a, b));
+        Integer remainder = integer_arena_alloc(&scratch, integer_div_remainder_size(a, b));
+        integer_div(&scratch, &quotient, &remainder, a, b);
+        check(t, group, test_integer_equals_u128(quotient, a_u128 / b_u128), u64, a_chunks[0]);
+        check(t, group, test_integer_equals_u128(remainder, a_u128 % b_u128), u64, a_chunks[0]);
+      }
+    }
+    // signs
+    /* NOTE: {a, b, quotient, remainder}, truncating like C */
+    i64 sign_tests[][4] = {
+      {7, 2, 3, 1},
+      {-7, 2, -3, -1},
+      {7, -2, -3, 1},
+      {-7, -2, 3, -1},
+      {6, -3, -2, 0},
+      {-6, -3, 2, 0},
+      {1, 7, 0, 1},
+      {-1, 7, 0, -1},
+      {MIN_i64, 7, MIN_i64 / 7, MIN_i64 % 7},
+      {MAX_i64, MIN_i64, 0, MAX_i64},
+    };
+    for (iptr i = 0; i < countof(sign_tests); i++) {
+      Integer a = (Integer){(u64 *)&sign_tests[i][0], 1};
+      Integer b = (Integer){(u64 *)&sign_tests[i][1], 1};
+      Integer expected_quotient = (Integer){(u64 *)&sign_tests[i][2], 1};
+      Integer expected_remainder = (Integer){(u64 *)&sign_tests[i][3], 1};
+      with_arena(&scratch) {
+        Integer quotient = integer_arena_alloc(&scratch, integer_div_quotient_size(a, b));
+        Integer remainder = integer_arena_alloc(&scratch, integer_div_remainder_size(a, b));
+        integer_div(&scratch, &quotient, &remainder, a, b);
+        check(t, group, test_integer_equals(quotient, expected_quotient), i64, sign_tests[i][0]);
+        check(t, group, test_integer_equals(remainder, expected_remainder), i64, sign_tests[i][0]);
+      }
+    }
+    /* NOTE: `MIN_i64 / -1` needs a second chunk */
+    {
+      u64 a_chunks[1] = {u64(MIN_i64)};
+      u64 b_chunks[1] = {u64(-1)};
+      u64 expected_chunks[2] = {u64(1) << 63, 0};
+      Integer a = (Integer){a_chunks, 1};
+      Integer b = (Integer){b_chunks, 1};
+      with_arena(&scratch) {
+        Integer quotient = integer_arena_alloc(&scratch, integer_div_quotient_size(a, b));
+        Integer remainder = integer_arena_alloc(&scratch, integer_div_remainder_size(a, b));
+        integer_div(&scratch, &quotient, &remainder, a, b);
+        check(t, group, test_integer_equals(quotient, (Integer){expected_chunks, 2}), u64, quotient.chunks[0]);
+        check(t, group, test_integer_is_zero(remainder), u64, remainder.chunks[0]);
+      }
+    }
+    // q_hat corrections
+    /* NOTE: {a, b, quotient, remainder}, the extra zero chunks keep them non-negative */
+    STRUCT(TestDiv) {
+      u64 a[5];
+      u64 b[4];
+      u64 quotient[2];
+      u64 remainder[4];
+    };
+    TestDiv div_tests[] = {
+      /* NOTE: the estimate from the top 2 chunks is 1 too big, and only the multiply-subtract notices, so we add back */
+      {{0, 0, u64(1) << 63, MAX_u64 >> 1, 0}, {1, 0, u64(1) << 63, 0}, {MAX_u64 - 1, 0}, {2, MAX_u64, MAX_u64 >> 1, 0}},
+      /* NOTE: `u_2 >= v_top`, so we start from `q_hat = MAX_u64`, and the 3rd chunk refines it */
+      {{0, MAX_u64 - 1, u64(1) << 63, 0, 0}, {MAX_u64, u64(1) << 63, 0, 0}, {MAX_u64, 0}, {MAX_u64, MAX_u64 >> 1, 0, 0}},
+      /* NOTE: a divisor that isn't normalized, so both operands get shifted */
+      {{0, 0, u64(1) << 63, 0, 0}, {u64(1) << 63, 1, 0, 0}, {0x5555555555555555, 0x5555555555555555}, {u64(1) << 63, 0, 0, 0}},
+    };
+    for (iptr i = 0; i < countof(div_tests); i++) {
+      TestDiv test = div_tests[i];
+      Integer a = (Integer){test.a, u64(countof(test.a))};
+      Integer b = (Integer){test.b, u64(countof(test.b))};
+      with_arena(&scratch) {
+        Integer quotient = integer_arena_alloc(&scratch, integer_div_quotient_size(a, b));
+        Integer remainder = integer_arena_alloc(&scratch, integer_div_remainder_size(a, b));
+        integer_div(&scratch, &quotient, &remainder, a, b);
+        check(t, group, test_integer_equals(quotient, (Integer){test.quotient, u64(countof(test.quotient))}), i64, i);
+        check(t, group, test_integer_equals(remainder, (Integer){test.remainder, u64(countof(test.remainder))}), i64, i);
+      }
+    }
+    // random sizes
+    for (iptr i = 0; i < 20000; i++) {
+      usize a_size = test_random(&state) % 48 + 1;
+      usize b_size = i % 4 == 0 ? 1 : test_random(&state) % (a_size + 2) + 1;
+      with_arena(&scratch) {
+        Integer a = integer_arena_alloc(&scratch, a_size);
+        Integer b = integer_arena_alloc(&scratch, b_size);
+        test_random_integer(&state, a);
+        test_random_integer(&state, b);
+        if (test_integer_is_zero(b)) b.chunks[0] = 1;
+        Integer quotient = integer_arena_alloc(&scratch, integer_div_quotient_size(a, b));
+        Integer remainder = integer_arena_alloc(&scratch, integer_div_remainder_size(a, b));
+        integer_div(&scratch, &quotient, &remainder, a, b);
+        check(t, group, test_div_is_correct(&scratch, a, b, quotient, remainder), u64, a_size << 32 | b_size);
+      }
+    }
+  }
+  test_summary(t, group);
+  // test integer_mul()
+  if (test_group(t, &group, string("integer_mul()"), 1)) {
+    u64 state = 0x510E527FADE682D1;
+    /* NOTE: both sides of each threshold, every pair so we also get the unbalanced cases */
+    usize sizes[] = {
+      1, 2, 3,
+      INTEGER_KARATSUBA_THRESHOLD - 1, INTEGER_KARATSUBA_THRESHOLD, INTEGER_KARATSUBA_THRESHOLD + 1,
+      2 * INTEGER_KARATSUBA_THRESHOLD - 1, 2 * INTEGER_KARATSUBA_THRESHOLD + 1,
+      INTEGER_TOOM3_THRESHOLD - 1, INTEGER_TOOM3_THRESHOLD, INTEGER_TOOM3_THRESHOLD + 1,
+      2 * INTEGER_TOOM3_THRESHOLD + 1,
+    };
+    for (iptr i = 0; i < countof(sizes); i++) {
+      for (iptr j = 0; j < countof(sizes); j++) {
+        /* NOTE: every sign combination */
+        for (u64 signs = 0; signs < 4; signs++) {
+          with_arena(&scratch) {
+            Integer a = integer_arena_alloc(&scratch, sizes[i]);
+            Integer b = integer_arena_alloc(&scratch, sizes[j]);
+            test_random_integer(&state, a);
+            test_random_integer(&state, b);
+            a.chunks[a.chunks_size - 1] = (a.chunks[a.chunks_size - 1] & (MAX_u64 >> 1)) | (signs & 1) << 63;
+            b.chunks[b.chunks_size - 1] = (b.chunks[b.chunks_size - 1] & (MAX_u64 >> 1)) | (signs >> 1) << 63;
+            check(t, group, test_mul_is_correct(&scratch, a, b), u64, sizes[i] << 32 | sizes[j]);
+          }
+        }
+      }
+    }
+    // random sizes
+    for (iptr i = 0; i < 300; i++) {
+      usize a_size = test_random(&state) % (3 * INTEGER_TOOM3_THRESHOLD) + 1;
+      usize b_size = test_random(&state) % (3 * INTEGER_TOOM3_THRESHOLD) + 1;
+      with_arena(&scratch) {
+        Integer a = integer_arena_alloc(&scratch, a_size);
+        Integer b = integer_arena_alloc(&scratch, b_size);
+        test_random_integer(&state, a);
+        test_random_integer(&state, b);
+        check(t, group, test_mul_is_correct(&scratch, a, b), u64, a_size << 32 | b_size);
+      }
+    }
+  }
+  test_summary(t, group);
+  // test integer_square()
+  if (test_group(t, &group, string("integer_square()"), 1)) {
+    u64 state = 0x9B05688C2B3E6C1F;
+    usize sizes[] = {
+      1, 2, 3,
+      INTEGER_KARATSUBA_SQUARE_THRESHOLD - 1, INTEGER_KARATSUBA_SQUARE_THRESHOLD, INTEGER_KARATSUBA_SQUARE_THRESHOLD + 1,
+      2 * INTEGER_KARATSUBA_SQUARE_THRESHOLD - 1, 2 * INTEGER_KARATSUBA_SQUARE_THRESHOLD + 1,
+      INTEGER_TOOM3_THRESHOLD + 1, 1000,
+    };
+    for (iptr i = 0; i < 4 * countof(sizes); i++) {
+      usize size = sizes[i / 4];
+      with_arena(&scratch) {
+        Integer a = integer_arena_alloc(&scratch, size);
+        test_random_integer(&state, a);
+        /* NOTE: the largest positive value of each size, so every chunk product carries */
+        if (i % 4 == 3) {
+          for (usize j = 0; j < size; j++) { a.chunks[j] = MAX_u64 >> (j + 1 == size); }
+        }
+        Integer square = integer_arena_alloc(&scratch, integer_square_size(a));
+        integer_square(&scratch, &square, a);
+        Integer expected = integer_arena_alloc(&scratch, integer_mul_size(a, a));
+        integer_mul(&scratch, &expected, a, a);
+        check(t, group, test_integer_equals(square, expected), u64, size);
+      }
+    }
+  }
+  test_summary(t, group);
+  // test integer_pow_u64()
+  if (test_group(t, &group, string("integer_pow_u64()"), 1)) {
+    u64 state = 0x1F83D9ABFB41BD6B;
+    u64 bases[] = {0, 1, 2, 3, 5, 10, 0xFFFFFFFF, MAX_u64, test_random(&state), test_random(&state) >> 32};
+    u64 exponents[] = {0, 1, 2, 3, 7, 8, 63, 64, 65, 100, 1000};
+    for (iptr i = 0; i < countof(bases); i++) {
+      for (iptr j = 0; j < countof(exponents); j++) {
+        u64 base = bases[i];
+        u64 exponent = exponents[j];
+        with_arena(&scratch) {
+          Integer power = integer_arena_alloc(&scratch, integer_pow_u64_size(base, exponent));
+          integer_pow_u64(&scratch, &power, base, exponent);
+          /* NOTE: multiply by `base`, `exponent` times, plus a zero chunk for the sign */
+          Integer expected = integer_arena_alloc(&scratch, exponent + 2);
+          for (usize k = 0; k < expected.chunks_size; k++) { expected.chunks[k] = 0; }
+          expected.chunks[0] = 1;
+          usize size = 1;
+          for (u64 k = 0; k < exponent; k++) {
+            u64 carry = _integer_mul_u64_unsigned((Integer){expected.chunks, size}, (Integer){expected.chunks, size}, base);
+            if (carry != 0) { expected.chunks[size++] = carry; }
+          }
+          check(t, group, test_integer_equals(power, expected), u64, base);
+        }
+      }
+    }
+  }
+  test_summary(t, group);
+  // test _ntt_add(), _ntt_sub(), _ntt_mul()
+  if (test_group(t, &group, string("_ntt_add(), _ntt_sub(), _ntt_mul()"), 1)) {
+    u64 state = 0x5BE0CD19137E2179;
+    /* NOTE: values near `p`, `2^32` and `2^63`, where the carry and wrap corrections kick in */
+    u64 values[] = {
+      0, 1, 2, NTT_EPSILON - 1, NTT_EPSILON, NTT_EPSILON + 1, u64(1) << 63,
+      NTT_PRIME - NTT_EPSILON, NTT_PRIME - 2, NTT_PRIME - 1,
+      test_random(&state) % NTT_PRIME, test_random(&state) % NTT_PRIME,
+    };
+    for (iptr i = 0; i < countof(values); i++) {
+      for (iptr j = 0; j < countof(values); j++) {
+        u64 a = values[i];
+        u64 b = values[j];
+        check(t, group, _ntt_add(a, b) == u64((u128(a) + b) % NTT_PRIME), u64, a);
+        check(t, group, _ntt_sub(a, b) == u64((u128(a) + NTT_PRIME - b) % NTT_PRIME), u64, a);
+        check(t, group, _ntt_mul(a, b) == u64(u128(a) * b % NTT_PRIME), u64, a);
+      }
+    }
+  }
+  test_summary(t, group);
+  // test _integer_toom3_mul_unsigned(), _integer_ntt_mul_unsigned()
+  if (test_group(t, &group, string("_integer_toom3_mul_unsigned(), _integer_ntt_mul_unsigned()"), 1)) {
+    u64 state = 0x6A09E667F3BCC908;
+    /* NOTE: just above the Toom-3 threshold, and lengths that aren't powers of two or multiples of 3,
+      with `b.chunks_size` as small as Toom-3 allows */
+    usize toom3_sizes[] = {INTEGER_TOOM3_THRESHOLD + 1, INTEGER_TOOM3_THRESHOLD + 2, INTEGER_TOOM3_THRESHOLD + 5, 3 * INTEGER_TOOM3_THRESHOLD + 1};
+    for (iptr i = 0; i < 3 * countof(toom3_sizes); i++) {
+      usize a_size = toom3_sizes[i / 3];
+      usize b_sizes[] = {a_size, a_size - 1, (a_size + 2) / 3 * 2 + 1};
+      usize b_size = b_sizes[i % 3];
+      /* NOTE: all-ones chunks, and random ones */
+      for (iptr pattern = 0; pattern < 2; pattern++) {
+        with_arena(&scratch) {
+          Integer a = integer_arena_alloc(&scratch, a_size);
+          Integer b = integer_arena_alloc(&scratch, b_size);
+          test_random_integer(&state, a);
+          test_random_integer(&state, b);
+          if (pattern == 0) {
+            for (usize j = 0; j < a_size; j++) { a.chunks[j] = MAX_u64; }
+            for (usize j = 0; j < b_size; j++) { b.chunks[j] = MAX_u64; }
+          }
+          check(t, group, test_mul_unsigned_is_correct(&scratch, _integer_toom3_mul_unsigned, a, b), u64, a_size << 32 | b_size);
+        }
+      }
+    }
+    /* NOTE: the NTT works for any sizes, so also test small ones that aren't powers of two */
+    usize ntt_sizes[] = {1, 3, 5, 17, 100, 1000, 4097};
+    for (iptr i = 0; i < countof(ntt_sizes); i++) {
+      for (iptr j = 0; j <= i; j++) {
+        for (iptr pattern = 0; pattern < 2; pattern++) {
+          with_arena(&scratch) {
+            Integer a = integer_arena_alloc(&scratch, ntt_sizes[i]);
+            Integer b = integer_arena_alloc(&scratch, ntt_sizes[j]);
+            test_random_integer(&state, a);
+            test_random_integer(&state, b);
+            if (pattern == 0) {
+              for (usize k = 0; k < a.chunks_size; k++) { a.chunks[k] = MAX_u64; }
+              for (usize k = 0; k < b.chunks_size; k++) { b.chunks[k] = MAX_u64; }
+            }
+            check(t, group, test_mul_unsigned_is_correct(&scratch, _integer_ntt_mul_unsigned, a, b), u64, ntt_sizes[i] << 32 | ntt_sizes[j]);
+          }
+        }
+      }
+    }
+    /* NOTE: through integer_mul(), just above the NTT threshold, with the largest positive value, so every 16-bit digit is all ones */
+    with_arena(&scratch) {
+      Integer a = integer_arena_alloc(&scratch, INTEGER_NTT_THRESHOLD + 1);
+      for (usize j = 0; j < a.chunks_size; j++) { a.chunks[j] = MAX_u64; }
+      a.chunks[a.chunks_size - 1] = MAX_u64 >> 1;
+      check(t, group, test_mul_is_correct(&scratch, a, a), u64, a.chunks_size);
+    }
+  }
+  test_summary(t, group);
+  // test integer_shift_left(), integer_shift_right()
+  if (test_group(t, &group, string("integer_shift_left(), integer_shift_right()"), 1)) {
+    u64 state = 0xBB67AE8584CAA73B;
+    usize shifts[] = {0, 1, 63, 64, 65, 127, 128, 129, 257, 300, 640};
+    usize sizes[] = {1, 2, 3, 5, 8};
+    for (iptr i = 0; i < countof(sizes); i++) {
+      for (iptr j = 0; j < countof(shifts); j++) {
+        usize a_size = sizes[i];
+        usize shift = shifts[j];
+        /* NOTE: result sizes that truncate, match and extend `a` */
+        usize result_sizes[] = {1, a_size, a_size + 1, a_size + 6};
+        for (iptr k = 0; k < 2 * countof(result_sizes); k++) {
+          usize result_size = result_sizes[k / 2];
+          bool is_negative = k % 2 == 1;
+          with_arena(&scratch) {
+            Integer a = integer_arena_alloc(&scratch, a_size);
+            test_random_integer(&state, a);
+            a.chunks[a_size - 1] = (a.chunks[a_size - 1] & (MAX_u64 >> 1)) | u64(is_negative) << 63;
+            u64 extension = integer_sign_extension(a);
+            Integer result = integer_arena_alloc(&scratch, result_size);
+            // left
+            integer_shift_left(&result, a, shift);
+            bool is_correct = true;
+            for (usize bit = 0; bit < 64 * result_size; bit++) {
+              u64 expected = bit < shift ? 0 : test_integer_bit(a, bit - shift, extension);
+              is_correct = is_correct && test_integer_bit(result, bit, 0) == expected;
+            }
+            check(t, group, is_correct, u64, a_size << 32 | shift);
+            // right
+            for (iptr l = 0; l < 2; l++) {
+              bool sign_extend = l == 1;
+              integer_shift_right(&result, a, shift, sign_extend);
+              is_correct = true;
+              for (usize bit = 0; bit < 64 * result_size; bit++) {
+                u64 expected = test_integer_bit(a, bit + shift, sign_extend ? extension : 0);
+                is_correct = is_correct && test_integer_bit(result, bit, 0) == expected;
+              }
+              check(t, group, is_correct, u64, a_size << 32 | shift);
+            }
+            /* NOTE: `result` may alias `a` */
+            if (result_size == a_size) {
+              Integer a_copy = integer_arena_alloc(&scratch, a_size);
+              integer_copy(&a_copy, a);
+              integer_shift_left(&result, a, shift);
+              integer_shift_left(&a_copy, a_copy, shift);
+              check(t, group, test_integer_equals(a_copy, result), u64, a_size << 32 | shift);
+              integer_copy(&a_copy, a);
+              integer_shift_right(&result, a, shift, true);
+              integer_shift_right(&a_copy, a_copy, shift, true);
+              check(t, group, test_integer_equals(a_copy, result), u64, a_size << 32 | shift);
+            }
+          }
+        }
+      }
+    }
+  }
+  test_summary(t, group);
+  // test integer_parse_decimal()
+  if (test_group(t, &group, string("integer_parse_decimal()"), 1)) {
+    TEST(string, Integer);
+    u64 chunks_0[] = {0};
+    u64 chunks_1[] = {1};
+    u64 chunks_m1[] = {MAX_u64};
+    u64 chunks_max[] = {MAX_u64, 0};
+    u64 chunks_2_64[] = {0, 1};
+    u64 chunks_m2_64[] = {0, MAX_u64};
+    u64 chunks_10_19[] = {INTEGER_10_POW_19, 0};
+    Test tests[] = {
+      {string(""), (Integer){chunks_0, 1}},
+      {string("0"), (Integer){chunks_0, 1}},
+      {string("-0"), (Integer){chunks_0, 1}},
+      {string("0000000000000000000000000"), (Integer){chunks_0, 1}},
+      {string("1"), (Integer){chunks_1, 1}},
+      {string("-1"), (Integer){chunks_m1, 1}},
+      {string("-0000000000000000000000001"), (Integer){chunks_m1, 1}},
+      {string("18446744073709551615"), (Integer){chunks_max, 2}},
+      {string("000000000000000000018446744073709551615"), (Integer){chunks_max, 2}},
+      {string("18446744073709551616"), (Integer){chunks_2_64, 2}},
+      {string("-18446744073709551616"), (Integer){chunks_m2_64, 2}},
+      {string("10000000000000000000"), (Integer){chunks_10_19, 2}},
+    };
+    for (iptr i = 0; i < countof(tests); i++) {
+      Test test = tests[i];
+      with_arena(&scratch) {
+        Integer result = integer_arena_alloc(&scratch, integer_parse_decimal_size(test.in));
+        integer_parse_decimal(&scratch, &result, test.in);
+        check(t, group, test_integer_equals(result, test.out), i64, i);
+      }
+    }
+    /* NOTE: divide-and-conquer against the schoolbook parse, on both sides of the threshold,
+      with lengths that aren't multiples of 19, leading zeros, and a '-' sign */
+    u64 state = 0x3F84D5B5B5470917;
+    usize sizes[] = {
+      1, 18, 19, 20, 1000,
+      INTEGER_DIGITS_PER_CHUNK * (INTEGER_PARSE_DECIMAL_THRESHOLD - 1) + 7,
+      INTEGER_DIGITS_PER_CHUNK * INTEGER_PARSE_DECIMAL_THRESHOLD,
+      INTEGER_DIGITS_PER_CHUNK * INTEGER_PARSE_DECIMAL_THRESHOLD + 1,
+      INTEGER_DIGITS_PER_CHUNK * (2 * INTEGER_PARSE_DECIMAL_THRESHOLD + 3) + 11,
+      INTEGER_DIGITS_PER_CHUNK * 5 * INTEGER_PARSE_DECIMAL_THRESHOLD + 5,
+    };
+    for (iptr i = 0; i < 4 * countof(sizes); i++) {
+      usize digits_size = sizes[i / 4];
+      bool is_negative = i % 2 == 1;
+      usize leading_zeros = i % 4 >= 2 ? usize(test_random(&state) % 50) + 1 : 0;
+      with_arena(&scratch) {
+        byte *buffer = arena_alloc_array(&scratch, byte, digits_size + 1 + leading_zeros);
+        usize size = 0;
+        if (is_negative) { buffer[size++] = '-'; }
+        for (usize j = 0; j < leading_zeros; j++) { buffer[size++] = '0'; }
+        test_random_digits(&state, buffer + size, digits_size);
+        string digits = (string){(rcstring)(buffer + size), digits_size};
+        size += digits_size;
+        string in = (string){(rcstring)buffer, size};
+        Integer result = integer_arena_alloc(&scratch, integer_parse_decimal_size(in));
+        integer_parse_decimal(&scratch, &result, in);
+        /* NOTE: `-expected`, or `expected` with a zero chunk on top */
+        Integer expected = integer_arena_alloc(&scratch, _integer_decimal_chunks(digits.size) + 1);
+        _integer_parse_decimal_schoolbook_unsigned(expected, digits);
+        if (is_negative) { integer_negate(&expected, expected); }
+        check(t, group, test_integer_equals(result, expected), u64, digits_size);
+      }
+    }
+  }
+  test_summary(t, group);
+  // test _integer_reciprocal_unsigned()
+  if (test_group(t, &group, string("_integer_reciprocal_unsigned()"), 1)) {
+    u64 state = 0x71374491B5C0FBCF;
+    usize sizes[] = {
+      2, 3,
+      INTEGER_RECIPROCAL_THRESHOLD - 1, INTEGER_RECIPROCAL_THRESHOLD, INTEGER_RECIPROCAL_THRESHOLD + 1,
+      2 * INTEGER_RECIPROCAL_THRESHOLD + 7, 100, 300,
+    };
+    for (iptr i = 0; i < 4 * countof(sizes); i++) {
+      usize n = sizes[i / 4];
+      with_arena(&scratch) {
+        Integer b = integer_arena_alloc(&scratch, n);
+        test_random_integer(&state, b);
+        /* NOTE: the smallest and largest top chunks, and a power of two */
+        if (i % 4 == 1) { b.chunks[n - 1] = 1; }
+        if (i % 4 == 2) { b.chunks[n - 1] = MAX_u64; }
+        if (i % 4 == 3) {
+          for (usize j = 0; j < n; j++) { b.chunks[j] = 0; }
+          b.chunks[n - 1] = u64(1) << 63;
+        }
+        if (b.chunks[n - 1] == 0) { b.chunks[n - 1] = 1; }
+        Integer reciprocal = integer_arena_alloc(&scratch, n + 2);
+        _integer_reciprocal_unsigned(&scratch, reciprocal, b);
+        /* NOTE: `floor(2^(128 * n) / b)` with long division */
+        Integer power = integer_arena_alloc(&scratch, 2 * n + 1);
+        for (usize j = 0; j < 2 * n; j++) { power.chunks[j] = 0; }
+        power.chunks[2 * n] = 1;
+        Integer expected = integer_arena_alloc(&scratch, n + 2);
+        Integer remainder = integer_arena_alloc(&scratch, n);
+        _integer_div_unsigned(&scratch, expected, remainder, power, b);
+        check(t, group, _integer_compare_unsigned(reciprocal, expected) == 0, u64, n);
+      }
+    }
+  }
+  test_summary(t, group);
+  // test integer_sprint_decimal()
+  if (test_group(t, &group, string("integer_sprint_decimal()"), 1)) {
+    TEST(Integer, string);
+    u64 chunks_0[] = {0};
+    u64 chunks_m1[] = {MAX_u64};
+    u64 chunks_min[] = {u64(1) << 63};
+    u64 chunks_10_19[] = {INTEGER_10_POW_19, 0};
+    u64 chunks_2_64[] = {0, 1};
+    u64 chunks_m2_64[] = {0, MAX_u64};
+    Test tests[] = {
+      {(Integer){chunks_0, 1}, string("0")},
+      {(Integer){chunks_m1, 1}, string("-1")},
+      {(Integer){chunks_min, 1}, string("-9223372036854775808")},
+      {(Integer){chunks_10_19, 2}, string("10000000000000000000")},
+      {(Integer){chunks_2_64, 2}, string("18446744073709551616")},
+      {(Integer){chunks_m2_64, 2}, string("-18446744073709551616")},
+    };
+    for (iptr i = 0; i < countof(tests); i++) {
+      Test test = tests[i];
+      with_arena(&scratch) {
+        usize buffer_size = integer_sprint_decimal_size(test.in);
+        byte *buffer_end = arena_alloc_array(&scratch, byte, buffer_size) + buffer_size;
+        usize size = integer_sprint_decimal(&scratch, test.in, buffer_end);
+        check(t, group, str_equals((string){(rcstring)(buffer_end - size), size}, test.out), i64, i);
+      }
+    }
+    /* NOTE: sprint then parse, on both sides of INTEGER_SPRINT_DECIMAL_THRESHOLD,
+      and long enough that the parse crosses INTEGER_PARSE_DECIMAL_THRESHOLD */
+    u64 state = 0xE9B5DBA53956C25B;
+    usize sizes[] = {
+      1, 2,
+      INTEGER_SPRINT_DECIMAL_THRESHOLD - 1, INTEGER_SPRINT_DECIMAL_THRESHOLD, INTEGER_SPRINT_DECIMAL_THRESHOLD + 1,
+      3 * INTEGER_SPRINT_DECIMAL_THRESHOLD + 5, INTEGER_PARSE_DECIMAL_THRESHOLD + 100, 3 * INTEGER_PARSE_DECIMAL_THRESHOLD,
+    };
+    for (iptr i = 0; i < 2 * countof(sizes); i++) {
+      usize a_size = sizes[i / 2];
+      with_arena(&scratch) {
+        Integer a = integer_arena_alloc(&scratch, a_size);
+        test_random_integer(&state, a);
+        a.chunks[a_size - 1] = (a.chunks[a_size - 1] & (MAX_u64 >> 1)) | u64(i % 2) << 63;
+        usize buffer_size = integer_sprint_decimal_size(a);
+        byte *buffer_end = arena_alloc_array(&scratch, byte, buffer_size) + buffer_size;
+        usize size = integer_sprint_decimal(&scratch, a, buffer_end);
+        string digits = (string){(rcstring)(buffer_end - size), size};
+        Integer parsed = integer_arena_alloc(&scratch, integer_parse_decimal_size(digits));
+        integer_parse_decimal(&scratch, &parsed, digits);
+        check(t, group, test_integer_equals(parsed, a), u64, a_size);
+      }
+    }
+    /* NOTE: parse then sprint, with long runs of zeros, so the low halves need `min_digits` padding */
+    usize digits_sizes[] = {
+      100,
+      INTEGER_DIGITS_PER_CHUNK * INTEGER_SPRINT_DECIMAL_THRESHOLD + 3,
+      INTEGER_DIGITS_PER_CHUNK * INTEGER_PARSE_DECIMAL_THRESHOLD + 1,
+      INTEGER_DIGITS_PER_CHUNK * 3 * INTEGER_PARSE_DECIMAL_THRESHOLD + 10,
+    };
+    for (iptr i = 0; i < 4 * countof(digits_sizes); i++) {
+      usize digits_size = digits_sizes[i / 4];
+      bool is_negative = i % 2 == 1;
+      with_arena(&scratch) {
+        byte *buffer = arena_alloc_array(&scratch, byte, digits_size + 1);
+        usize start = is_negative ? 1 : 0;
+        buffer[0] = '-';
+        byte *digits = buffer + start;
+        test_random_digits(&state, digits, digits_size);
+        if (i % 4 < 2) {
+          /* NOTE: `10^(digits_size - 1) + 1` */
+          for (usize j = 0; j < digits_size; j++) { digits[j] = '0'; }
+          digits[digits_size - 1] = '1';
+        } else {
+          /* NOTE: zeros in the middle half */
+          for (usize j = digits_size / 4; j < digits_size * 3 / 4; j++) { digits[j] = '0'; }
+        }
+        digits[0] = '1';
+        string in = (string){(rcstring)buffer, digits_size + start};
+        Integer parsed = integer_arena_alloc(&scratch, integer_parse_decimal_size(in));
+        integer_parse_decimal(&scratch, &parsed, in);
+        usize buffer_size = integer_sprint_decimal_size(parsed);
+        byte *buffer_end = arena_alloc_array(&scratch, byte, buffer_size) + buffer_size;
+        usize size = integer_sprint_decimal(&scratch, parsed, buffer_end);
+        check(t, group, str_equals((string){(rcstring)(buffer_end - size), size}, in), u64, digits_size);
+      }
+    }
+  }
+  test_summary(t, group);
+  // test integer_pow5_cached(), integer_pow10_cached()
+  if (test_group(t, &group, string("integer_pow5_cached(), integer_pow10_cached()"), 0)) {
+    /* NOTE: exponents no other test has cached yet, and their halves overlap,
+      so the threads race to own the same entries at every level */
+    u64 exponents[64];
+    for (iptr i = 0; i < countof(exponents); i++) {
+      exponents[i] = 3001 + 37 * u64(i);
+    }
+    for (iptr i = 0; i < countof(exponents); i++) {
+      /* NOTE: every thread asks for the same 5^exponent at the same time, but for 10^exponent in a different order */
+      barrier(t);
+      u64 exponent = exponents[i];
+      u64 exponent10 = exponents[(i + t) % countof(exponents)];
+      with_arena(&scratch) {
+        Integer pow5 = integer_pow5_cached(&scratch, exponent);
+        Integer expected5 = integer_arena_alloc(&scratch, integer_pow_u64_size(5, exponent));
+        integer_pow_u64(&scratch, &expected5, 5, exponent);
+        check(t, group, test_integer_equals(pow5, expected5), u64, exponent);
+        Integer pow10 = integer_pow10_cached(&scratch, exponent10);
+        Integer expected10 = integer_arena_alloc(&scratch, integer_pow_u64_size(10, exponent10));
+        integer_pow_u64(&scratch, &expected10, 10, exponent10);
+        check(t, group, test_integer_equals(pow10, expected10), u64, exponent10);
+      }
+    }
+  }
+  test_summary(t, group);
+  // test rational_to_f64()
+  if (test_group(t, &group, string("rational_to_f64()"), 1)) {
+    /* NOTE: `(a * 2^a_shift) / (b * 2^b_shift)`, and the bits of the correctly rounded f64 */
+    STRUCT(TestRational) {
+      i64 a;
+      usize a_shift;
+      i64 b;
+      usize b_shift;
+      u64 bits;
+    };
+    TestRational tests[] = {
+      {0, 0, 5, 0, 0x0000000000000000},
+      {1, 0, 1, 0, 0x3FF0000000000000},
+      {1, 0, 3, 0, 0x3FD5555555555555},
+      {-1, 0, 3, 0, 0xBFD5555555555555},
+      {1, 0, -3, 0, 0xBFD5555555555555},
+      {-1, 0, -3, 0, 0x3FD5555555555555},
+      {2, 0, 3, 0, 0x3FE5555555555555},
+      {1, 0, 10, 0, 0x3FB999999999999A},
+      /* NOTE: halfway cases round to even, and anything above halfway rounds up */
+      {(i64(1) << 53) + 1, 0, 2, 0, 0x4330000000000000},
+      {(i64(1) << 53) + 3, 0, 2, 0, 0x4330000000000002},
+      {(i64(1) << 53) + 1, 0, 1, 0, 0x4340000000000000},
+      {(i64(1) << 53) + 3, 0, 1, 0, 0x4340000000000002},
+      {(i64(1) << 54) + 3, 0, 4, 0, 0x4330000000000001},
+      {((i64(1) << 53) + 1) * 3 + 1, 0, 6, 0, 0x4330000000000001},
+      {((i64(1) << 53) + 1) * 3 - 1, 0, 6, 0, 0x4330000000000000},
+      {-((i64(1) << 53) + 1), 0, 2, 0, 0xC330000000000000},
+      /* NOTE: halfway on a huge denominator, so the sticky bit comes from the remainder */
+      {(i64(1) << 53) + 1, 200, 1, 201, 0x4330000000000000},
+      {(i64(1) << 53) + 1, 200, 3, 201, 0x4315555555555556},
+      /* NOTE: subnormals */
+      {1, 0, 1, 1022, 0x0010000000000000},
+      {1, 0, 1, 1074, 0x0000000000000001},
+      {1, 0, 1, 1075, 0x0000000000000000},
+      {3, 0, 1, 1076, 0x0000000000000001},
+      {3, 0, 1, 1075, 0x0000000000000002},
+      {(i64(1) << 52) - 1, 0, 1, 1074, 0x000FFFFFFFFFFFFF},
+      {(i64(1) << 53) - 1, 0, 1, 1075, 0x0010000000000000},
+      {-1, 0, 1, 1074, 0x8000000000000001},
+      {1, 0, 3, 1074, 0x0000000000000000},
+      {2, 0, 3, 1074, 0x0000000000000001},
+      {1, 0, 1, 2000, 0x0000000000000000},
+      /* NOTE: overflow */
+      {(i64(1) << 53) - 1, 971, 1, 0, 0x7FEFFFFFFFFFFFFF},
+      {(i64(1) << 55) - 3, 969, 1, 0, 0x7FEFFFFFFFFFFFFF},
+      {(i64(1) << 54) - 3, 970, 1, 0, 0x7FEFFFFFFFFFFFFE},
+      {(i64(1) << 54) - 1, 970, 1, 0, 0x7FF0000000000000},
+      {1, 1024, 1, 0, 0x7FF0000000000000},
+      {-1, 1024, 1, 0, 0xFFF0000000000000},
+      {1, 2000, 3, 0, 0x7FF0000000000000},
+    };
+    for (iptr i = 0; i < countof(tests); i++) {
+      TestRational test = tests[i];
+      with_arena(&scratch) {
+        Integer a = integer_arena_alloc(&scratch, test.a_shift / 64 + 2);
+        Integer b = integer_arena_alloc(&scratch, test.b_shift / 64 + 2);
+        integer_shift_left(&a, (Integer){(u64 *)&test.a, 1}, test.a_shift);
+        integer_shift_left(&b, (Integer){(u64 *)&test.b, 1}, test.b_shift);
+        f64 value = rational_to_f64(&scratch, (Rational){&a, &b});
+        check(t, group, bitcast(value, f64, u64) == test.bits, i64, i);
+      }
+    }
+    /* NOTE: `10^400` and `10^-400` */
+    with_arena(&scratch) {
+      u64 one_chunks[] = {1};
+      Integer one = (Integer){one_chunks, 1};
+      Integer power = integer_arena_alloc(&scratch, integer_pow_u64_size(10, 400));
+      integer_pow_u64(&scratch, &power, 10, 400);
+      f64 value = rational_to_f64(&scratch, (Rational){&power, &one});
+      check(t, group, bitcast(value, f64, u64) == 0x7FF0000000000000, u64, bitcast(value, f64, u64));
+      value = rational_to_f64(&scratch, (Rational){&one, &power});
+      check(t, group, bitcast(value, f64, u64) == 0, u64, bitcast(value, f64, u64));
+    }
+  }
+  test_summary(t, group);
+  // test integer_mul_parallel()
+  if (test_group(t, &group, string("integer_mul_parallel()"), 0)) {
+    /* NOTE: around INTEGER_PARALLEL_MUL_THRESHOLD, and unbalanced sizes that stay on one thread */
+    usize sizes[][2] = {
+      {INTEGER_PARALLEL_MUL_THRESHOLD - 1, INTEGER_PARALLEL_MUL_THRESHOLD - 1},
+      {INTEGER_PARALLEL_MUL_THRESHOLD, INTEGER_PARALLEL_MUL_THRESHOLD},
+      {INTEGER_PARALLEL_MUL_THRESHOLD + 1, INTEGER_PARALLEL_MUL_THRESHOLD + 1},
+      {2 * INTEGER_PARALLEL_MUL_THRESHOLD + 3, 2 * INTEGER_PARALLEL_MUL_THRESHOLD + 1},
+      {INTEGER_PARALLEL_MUL_THRESHOLD + 5, 2 * INTEGER_PARALLEL_MUL_THRESHOLD},
+      {3 * INTEGER_PARALLEL_MUL_THRESHOLD, INTEGER_PARALLEL_MUL_THRESHOLD},
+    };
+    for (iptr i = 0; i < 4 * countof(sizes); i++) {
+      with_arena(&scratch) {
+        /* NOTE: {a, b, result}, shared by all threads */
+        Integer *operands = nil;
+        bool is_first = single_core(t);
+        if (is_first) {
+          /* NOTE: any thread can get here, so seed from `i` to stay reproducible */
+          u64 state = 0x243F6A8885A308D3 + u64(i);
+          operands = arena_alloc_array(&scratch, Integer, 3);
+          operands[0] = integer_arena_alloc(&scratch, sizes[i / 4][0]);
+          operands[1] = integer_arena_alloc(&scratch, sizes[i / 4][1]);
+          for (usize j = 0; j < 2; j++) {
+            Integer operand = operands[j];
+            test_random_integer(&state, operand);
+            u64 sign = u64(i >> j) & 1;
+            operand.chunks[operand.chunks_size - 1] = (operand.chunks[operand.chunks_size - 1] & (MAX_u64 >> 1)) | sign << 63;
+          }
+          operands[2] = integer_arena_alloc(&scratch, integer_mul_size(operands[0], operands[1]));
+        }
+        barrier_scatter(t, &operands);
+        integer_mul_parallel(t, &scratch, &operands[2], operands[0], operands[1]);
+        if (is_first) {
+          Integer expected = integer_arena_alloc(&scratch, integer_mul_size(operands[0], operands[1]));
+          integer_mul(&scratch, &expected, operands[0], operands[1]);
+          check(t, group, test_integer_equals(operands[2], expected), u64, operands[0].chunks_size << 32 | operands[1].chunks_size);
+        }
+        barrier(t); /* NOTE: make sure all threads are done with `operands` */
+      }
+    }
+  }
+  test_summary(t, group);
+}
@@ -28,6 +28,10 @@ void main_multicore(Thread t) {
       {string("0"), 0},
       {string("1"), 1},
       {string("18446744073709551615"), 18446744073709551615ULL},
+      {string("18446744073709551616"), 1844674407370955161ULL},
+      {string("12345678901234567890"), 12345678901234567890ULL},
+      {string("000000000000000000000000012345678"), 12345678},
+      {string("1234567x90123456789"), 1234567},
     };
     for (iptr i = 0; i < countof(tests); i++) {
       Test test = tests[i];
@@ -46,6 +50,10 @@ void main_multicore(Thread t) {
       {string("9223372036854775807"), 9223372036854775807},
       {string("-9223372036854775808"), (int64_t)9223372036854775808ULL},
       {string("-9223372036854775808"), -(int64_t)9223372036854775807ULL - 1},
+      {string("-9223372036854775809"), -922337203685477580},
+      {string("-123456789012345678"), -123456789012345678},
+      {string("+12345678:"), 12345678},
+      {string("-12345678:"), -12345678},
     };
     for (iptr i = 0; i < countof(tests); i++) {
       Test test = tests[i];
@@ -65,6 +73,10 @@ void main_multicore(Thread t) {
       {string("abcdef"), 0xABCDEF},
       {string("FEDCAB"), 0xFEDCAB},
       {string("FFFFFFFFFFFFFFFF"), 0xFFFFFFFFFFFFFFFF},
+      {string("1FFFFFFFFFFFFFFFF"), 0x1FFFFFFFFFFFFFFF},
+      {string("0123456789abcdefg"), 0x0123456789ABCDEF},
+      {string("89ABCDEFgh"), 0x89ABCDEF},
+      {string("89ABCDEG"), 0x89ABCDE},
     };
     for (iptr i = 0; i < countof(tests); i++) {
       Test test = tests[i];
@@ -74,6 +86,56 @@ void main_multicore(Thread t) {
     }
   }
   test_summary(t, group);
+  // test qf_parse_u128_decimal()
+  if (test_group(t, &group, string("qf_parse_u128_decimal()"), 1)) {
+    TEST(string, qf_u128);
+    Test tests[] = {
+      {string("0"), {0, 0}},
+      {string("18446744073709551616"), {1, 0}},
+      {string("123456789012345678901234567890"), {0x18EE90FF6, 0xC373E0EE4E3F0AD2}},
+      {string("340282366920938463463374607431768211455"), {0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF}},
+      {string("340282366920938463463374607431768211456"), {0x1999999999999999, 0x9999999999999999}},
+    };
+    for (iptr i = 0; i < countof(tests); i++) {
+      Test test = tests[i];
+      iptr end;
+      qf_u128 parsed = qf_parse_u128_decimal(test.in.ptr, (iptr)test.in.size, 0, &end);
+      check(t, group, parsed.high == test.out.high && parsed.low == test.out.low, u64, parsed.low);
+      // round trip
+      char buffer[QF_MAX_DIGITS_u128];
+      iptr size = qf_format_u128_decimal(buffer, parsed);
+      bool round_trip = str_equals((string){buffer, usize(size)}, str_slice(test.in, 0, end));
+      check(t, group, round_trip, bool, round_trip);
+    }
+  }
+  test_summary(t, group);
+  // test qf_parse_u64_column()
+  if (test_group(t, &group, string("qf_parse_u64_column()"), 1)) {
+    string column = string("0000000001|1234567890|9876543210|0000012345|");
+    u64 expected[] = {1, 1234567890, 9876543210, 12345};
+    u64 parsed[countof(expected)];
+    bool valid = qf_parse_u64_column(column.ptr, 0, 11, 10, countof(expected), parsed);
+    check(t, group, valid, bool, valid);
+    for (iptr i = 0; i < countof(expected); i++) {
+      check(t, group, parsed[i] == expected[i], u64, parsed[i]);
+    }
+    valid = qf_parse_u64_column(column.ptr, 0, 11, 11, countof(expected), parsed);
+    check(t, group, !valid, bool, valid);
+  }
+  test_summary(t, group);
+  // test qf_parse_u64_fields()
+  if (test_group(t, &group, string("qf_parse_u64_fields()"), 1)) {
+    string record = string("20240101 123456789012345678 7");
+    qf_field fields[] = {{0, 4}, {4, 2}, {6, 2}, {9, 18}, {28, 1}};
+    u64 expected[] = {2024, 1, 1, 123456789012345678, 7};
+    u64 parsed[countof(expected)];
+    bool valid = qf_parse_u64_fields(record.ptr, fields, countof(fields), parsed);
+    check(t, group, valid, bool, valid);
+    for (iptr i = 0; i < countof(expected); i++) {
+      check(t, group, parsed[i] == expected[i], u64, parsed[i]);
+    }
+  }
+  test_summary(t, group);
   // test qf_parse_f64_significand()
   if (test_group(t, &group, string("qf_parse_f64_significand()"), 1)) {
     TEST(string, u64);
@@ -0,0 +1,263 @@
+// clang build.c -o build.exe && ./build.exe
+#include "../qfloat_dd_parallel.h"
+#include "../utils/entry.h"
+#include "../utils/tests.h"
+
+/* NOTE: `[2**exponent, 2**(exponent+1))` with a random sign and mantissa */
+f64 test_random_f64(u64 *state, i32 exponent) {
+  u64 bits = test_random(state);
+  u64 sign = bits & (u64(1) << 63);
+  u64 mantissa = bits & ((u64(1) << 52) - 1);
+  return bitcast(sign | u64(1023 + exponent) << 52 | mantissa, u64, f64);
+}
+qfloat_dd test_random_dd(u64 *state, i32 exponent) {
+  return (qfloat_dd){test_random_f64(state, exponent), test_random_f64(state, exponent - 54)};
+}
+/* NOTE: relative error of a double-double, `(a - b) / b` */
+f64 test_dd_error(qfloat_dd a, qfloat_dd b) {
+  return __builtin_fabs(((a.high - b.high) + (a.low - b.low)) / b.high);
+}
+/* NOTE: `x`, then `y`, then `-x` reversed, the sum is exactly `sum(y)`, naive summation gets ~96% of these wrong,
+  but Sum2 is accurate to `eps * abs(sum) + (n * eps)**2 * sum(abs(values))`, which is well under `ulp(sum(y)) / 2` */
+#define TEST_DD_MAX_VALUES 512
+f64 test_ill_conditioned_sum(u64 *state, f64 *values, iptr x_count, iptr y_count) {
+  f64 sum = 0.0;
+  for (iptr i = 0; i < x_count; i++) {
+    f64 x = test_random_f64(state, i32(test_random(state) % 41));
+    values[i] = x;
+    values[x_count * 2 + y_count - 1 - i] = -x;
+  }
+  for (iptr i = 0; i < y_count; i++) {
+    /* NOTE: integers in `[2**19, 2**20)`, so that `sum(y)` is exact */
+    f64 y = f64(test_random(state) % (1 << 19) + (1 << 19));
+    values[x_count + i] = y;
+    sum += y;
+  }
+  return sum;
+}
+
+global f64 test_values[TEST_DD_MAX_VALUES];
+global f64 test_values2[TEST_DD_MAX_VALUES];
+void thread_main(Thread t) {
+  TestGroup *group;
+  // test qfloat_sum_f64()
+  if (test_group(t, &group, string("qfloat_sum_f64()"), 1)) {
+    /* NOTE: move {1e100, 1, -1e100} through every lane and the tail */
+    for (iptr offset = 0; offset < 3 * QFLOAT_DD_LANES; offset++) {
+      for (iptr count = offset + 3; count < offset + 3 + QFLOAT_DD_LANES; count++) {
+        for (iptr i = 0; i < count; i++) {
+          test_values[i] = 0.0;
+        }
+        test_values[offset] = 1e100;
+        test_values[offset + 1] = 1.0;
+        test_values[offset + 2] = -1e100;
+        qfloat_dd sum = qfloat_sum_f64(test_values, count);
+        check(t, group, sum.high == 1.0 && sum.low == 0.0, i64, count);
+      }
+    }
+    u64 state = 0x9E3779B97F4A7C15;
+    for (iptr i = 0; i < 1000; i++) {
+      iptr x_count = iptr(test_random(&state) % 200);
+      iptr y_count = iptr(test_random(&state) % 100) + 1;
+      f64 expected = test_ill_conditioned_sum(&state, test_values, x_count, y_count);
+      qfloat_dd sum = qfloat_sum_f64(test_values, x_count * 2 + y_count);
+      check(t, group, sum.high == expected, u64, bitcast(sum.high, f64, u64));
+    }
+  }
+  test_summary(t, group);
+  // test qfloat_dot_f64()
+  if (test_group(t, &group, string("qfloat_dot_f64()"), 1)) {
+    u64 state = 0xD1B54A32D192ED03;
+    for (iptr i = 0; i < 1000; i++) {
+      /* NOTE: `x*u` and `x*(-u)` cancel, including the rounding errors of the products */
+      iptr x_count = iptr(test_random(&state) % 200);
+      iptr y_count = iptr(test_random(&state) % 100) + 1;
+      iptr count = x_count * 2 + y_count;
+      f64 expected = test_ill_conditioned_sum(&state, test_values, x_count, y_count);
+      for (iptr j = 0; j < x_count; j++) {
+        test_values[j] = __builtin_fabs(test_values[j]) * 0x1p-20;
+        test_values[count - 1 - j] = test_values[j];
+        f64 u = test_random_f64(&state, i32(test_random(&state) % 21));
+        test_values2[j] = u;
+        test_values2[count - 1 - j] = -u;
+      }
+      for (iptr j = x_count; j < x_count + y_count; j++) {
+        test_values2[j] = 1.0;
+      }
+      qfloat_dd dot = qfloat_dot_f64(test_values, test_values2, count);
+      check(t, group, dot.high == expected, u64, bitcast(dot.high, f64, u64));
+    }
+  }
+  test_summary(t, group);
+  // test qfloat_parallel_sum_f64()
+  if (test_group(t, &group, string("qfloat_parallel_sum_f64()"), 0)) {
+    u64 state = 0x94D049BB133111EB;
+    for (iptr i = 0; i < 300; i++) {
+      iptr test_count = 0;
+      f64 test_expected = 0.0;
+      if (t == 0) {
+        if (i < 100) {
+          /* NOTE: {1e100, 1, -1e100} split across threads */
+          test_count = iptr(test_random(&state) % (TEST_DD_MAX_VALUES - 3)) + 3;
+          for (iptr j = 0; j < test_count; j++) {
+            test_values[j] = 0.0;
+          }
+          test_values[0] = 1e100;
+          test_values[test_count / 2] = 1.0;
+          test_values[test_count - 1] = -1e100;
+          test_expected = 1.0;
+        } else {
+          iptr x_count = iptr(test_random(&state) % 200);
+          iptr y_count = iptr(test_random(&state) % 100) + 1;
+          test_count = x_count * 2 + y_count;
+          test_expected = test_ill_conditioned_sum(&state, test_values, x_count, y_count);
+        }
+      }
+      barrier_scatter(t, &test_count);
+      barrier_scatter(t, &test_expected);
+      qfloat_dd sum = qfloat_parallel_sum_f64(t, test_values, test_count);
+      check(t, group, sum.high == test_expected, u64, bitcast(sum.high, f64, u64));
+      /* NOTE: every thread gets the same result */
+      u64 *sums = barrier_gather(t, &sum);
+      qfloat_dd first_sum = *(qfloat_dd *)sums[global_threads.thread_infos[t].threads_start];
+      bool is_same = bitcast(sum.high, f64, u64) == bitcast(first_sum.high, f64, u64)
+                     && bitcast(sum.low, f64, u64) == bitcast(first_sum.low, f64, u64);
+      check(t, group, is_same, bool, is_same);
+      barrier(t); /* NOTE: make sure all threads have read the sums */
+    }
+  }
+  test_summary(t, group);
+  // test qfloat_dd_*_array()
+  if (test_group(t, &group, string("qfloat_dd_*_array()"), 1)) {
+    u64 state = 0x2545F4914F6CDD1D;
+    f64 a_high[3 * QFLOAT_DD_LANES];
+    f64 a_low[3 * QFLOAT_DD_LANES];
+    f64 b_high[3 * QFLOAT_DD_LANES];
+    f64 b_low[3 * QFLOAT_DD_LANES];
+    f64 result_high[3 * QFLOAT_DD_LANES];
+    f64 result_low[3 * QFLOAT_DD_LANES];
+    qfloat_dd_array a = {a_high, a_low};
+    qfloat_dd_array b = {b_high, b_low};
+    qfloat_dd_array result = {result_high, result_low};
+    for (iptr count = 1; count <= 3 * QFLOAT_DD_LANES; count++) {
+      for (iptr i = 0; i < count; i++) {
+        qfloat_dd a_i = test_random_dd(&state, i32(test_random(&state) % 21) - 10);
+        qfloat_dd b_i = test_random_dd(&state, i32(test_random(&state) % 21) - 10);
+        a_high[i] = a_i.high;
+        a_low[i] = a_i.low;
+        b_high[i] = b_i.high;
+        b_low[i] = b_i.low;
+      }
+      /* NOTE: the scalar versions are the reference, up to fma contraction */
+      qfloat_dd_add_array(result, a, b, count);
+      for (iptr i = 0; i < count; i++) {
+        qfloat_dd expected = augmented_add_dd((qfloat_dd){a_high[i], a_low[i]}, (qfloat_dd){b_high[i], b_low[i]});
+        f64 error = test_dd_error((qfloat_dd){result_high[i], result_low[i]}, expected);
+        check(t, group, error <= 0x1p-100 || expected.high == 0.0, u64, bitcast(error, f64, u64));
+      }
+      qfloat_dd_mul_array(result, a, b, count);
+      for (iptr i = 0; i < count; i++) {
+        qfloat_dd expected = augmented_mul_dd((qfloat_dd){a_high[i], a_low[i]}, (qfloat_dd){b_high[i], b_low[i]});
+        f64 error = test_dd_error((qfloat_dd){result_high[i], result_low[i]}, expected);
+        check(t, group, error <= 0x1p-100, u64, bitcast(error, f64, u64));
+      }
+      qfloat_dd_div_array(result, a, b, count);
+      for (iptr i = 0; i < count; i++) {
+        qfloat_dd expected = augmented_div_dd((qfloat_dd){a_high[i], a_low[i]}, (qfloat_dd){b_high[i], b_low[i]});
+        f64 error = test_dd_error((qfloat_dd){result_high[i], result_low[i]}, expected);
+        check(t, group, error <= 0x1p-100, u64, bitcast(error, f64, u64));
+      }
+      /* NOTE: `sqrt(a)**2 == a` */
+      for (iptr i = 0; i < count; i++) {
+        a_low[i] = a_high[i] < 0.0 ? -a_low[i] : a_low[i];
+        a_high[i] = __builtin_fabs(a_high[i]);
+      }
+      a_high[0] = 0.0;
+      a_low[0] = 0.0;
+      qfloat_dd_sqrt_array(result, a, count);
+      check(t, group, result_high[0] == 0.0 && result_low[0] == 0.0, u64, bitcast(result_high[0], f64, u64));
+      for (iptr i = 1; i < count; i++) {
+        qfloat_dd root = {result_high[i], result_low[i]};
+        f64 error = test_dd_error(augmented_mul_dd(root, root), (qfloat_dd){a_high[i], a_low[i]});
+        check(t, group, error <= 0x1p-100, u64, bitcast(error, f64, u64));
+      }
+    }
+  }
+  test_summary(t, group);
+  // test qfloat_parse_f64_decimal()
+  if (test_group(t, &group, string("qfloat_parse_f64_decimal()"), 1)) {
+    TEST(string, u64);
+    /* NOTE: `SAFE_POWERS_OF_10[e % 16] * POWERS_OF_10_DD[e / 16]`, so these hit each side of the table steps,
+      and the ends of the 20-entry table, expected bits are from glibc strtod() */
+    Test tests[] = {
+      {string("1e15"), 0x430C6BF526340000},
+      {string("1e16"), 0x4341C37937E08000},
+      {string("1e17"), 0x4376345785D8A000},
+      {string("1e18"), 0x43ABC16D674EC800},
+      {string("1e19"), 0x43E158E460913D00},
+      {string("1e31"), 0x465F8DEF8808B024},
+      {string("1e32"), 0x4693B8B5B5056E17},
+      {string("123456789e10"), 0x43B12210F4768DB4},
+      {string("6.3551853199612532e33"), 0x46F3955B745DA82D},
+      {string("3.1799310452263575e34"), 0x47187F4EE6AAAB4B},
+      {string("1.6344555585831756e35"), 0x473F7A7CF245F406},
+      {string("1e303"), 0x7ED754E31CD072DA},
+      {string("1e304"), 0x7F0D2A1BE4048F90},
+      {string("1e305"), 0x7F423A516E82D9BA},
+      {string("7.5316214708379351e305"), 0x7F71291E210EC00A},
+      {string("1.7976931348623157e308"), 0x7FEFFFFFFFFFFFFF},
+      {string("8.0193853087996915e-1"), 0x3FE9A97AFE710420},
+      {string("1e-15"), 0x3CD203AF9EE75616},
+      {string("1e-16"), 0x3C9CD2B297D889BC},
+      {string("1e-17"), 0x3C670EF54646D497},
+      {string("1e-19"), 0x3BFD83C94FB6D2AC},
+      {string("9.3650741747880991e-15"), 0x3D05169903240F5C},
+      {string("9.7690697198814374e-288"), 0x0457CCF8402D0F3E},
+      {string("1e-303"), 0x0105F1CA820511C3},
+      {string("1e-304"), 0x00D18E3B9B374169},
+      {string("1e-305"), 0x009C16C5C5253575},
+      {string("2.4777781807529965e-303"), 0x011B2FD1EE1B1154},
+      {string("2.2250738585072014e-308"), 0x0010000000000000},
+      {string("-1e19"), 0xC3E158E460913D00},
+    };
+    for (iptr i = 0; i < countof(tests); i++) {
+      Test test = tests[i];
+      iptr end;
+      f64 parsed = qfloat_parse_f64_decimal(test.in.ptr, iptr(test.in.size), 0, &end);
+      check(t, group, bitcast(parsed, f64, u64) == test.out && end == iptr(test.in.size), u64, bitcast(parsed, f64, u64));
+    }
+  }
+  test_summary(t, group);
+  // test qfloat_sprint_f64_digits()
+  if (test_group(t, &group, string("qfloat_sprint_f64_digits()"), 1)) {
+    TEST(u64, string);
+    /* NOTE: `nextafter(10**k, 0)` scales to just under 1e16, expected strings are from glibc `%.17g` */
+    Test tests[] = {
+      {0x01A56E1FC2F8F358, string("9.9999999999999986e-301")},
+      {0x034FEEF63F97D79B, string("9.9999999999999994e-293")},
+      {0x16687E92154EF7AB, string("9.9999999999999984e-201")},
+      {0x2B2BFF2EE48E052F, string("9.9999999999999989e-101")},
+      {0x3DA5FD7FE1796494, string("9.9999999999999978e-12")},
+      {0x3FB9999999999999, string("0.099999999999999992")},
+      {0x4023FFFFFFFFFFFF, string("9.9999999999999982")},
+      {0x4341C37937E07FFF, string("9999999999999998")},
+      {0x4376345785D89FFF, string("99999999999999984")},
+      {0x4480F0CF064DD591, string("9.9999999999999979e+21")},
+      {0x44B52D02C7E14AF5, string("9.9999999999999975e+22")},
+      {0x54B249AD2594C37C, string("9.9999999999999982e+99")},
+      {0x6974E718D7D76259, string("9.999999999999998e+199")},
+      {0x7E031CFD3999F7AF, string("9.9999999999999987e+298")},
+      {0x44EA784379D99DB4, string("9.9999999999999998e+23")},
+      {0x0383F559E7BEE6C1, string("9.9999999999999996e-292")},
+      {0x44B52D02C7E14AF6, string("9.9999999999999992e+22")},
+      {0x4341C37937E08000, string("10000000000000000")},
+    };
+    for (iptr i = 0; i < countof(tests); i++) {
+      Test test = tests[i];
+      char buffer[QFLOAT_SIZE_f64];
+      iptr size = qfloat_sprint_f64_digits(bitcast(test.in, u64, f64), buffer);
+      check(t, group, str_equals((string){buffer, usize(size)}, test.out), u64, test.in);
+    }
+  }
+  test_summary(t, group);
+}
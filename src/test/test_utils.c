@@ -0,0 +1,215 @@
+// clang build.c -o build.exe && ./build.exe
+#include "../utils/entry.h"
+#include "../utils/fmt.h"
+#include "../utils/mem.h"
+#include "../utils/tasks.h"
+#include "../utils/tests.h"
+
+// tasks
+/* NOTE: a tree of tasks, where task `id` spawns `id * TEST_TASK_FANOUT + 1` to `id * TEST_TASK_FANOUT + TEST_TASK_FANOUT` */
+#define TEST_TASK_FANOUT 4
+#define TEST_TASK_COUNT  5461 /* NOTE: `1 + 4 + ... + 4^6` */
+global u32 test_task_run_counts[TEST_TASK_COUNT];
+void test_task(Thread t, rawptr data) {
+  uptr id = uptr(data);
+  atomic_add_fetch(&test_task_run_counts[id], 1);
+  for (uptr child = id * TEST_TASK_FANOUT + 1; child <= id * TEST_TASK_FANOUT + TEST_TASK_FANOUT && child < TEST_TASK_COUNT; child++) {
+    task_spawn(t, test_task, rawptr(child));
+  }
+}
+
+// parallel for
+#define TEST_PARALLEL_FOR_SIZE 1000
+global u32 test_parallel_for_counts[TEST_PARALLEL_FOR_SIZE];
+
+void thread_main(Thread t) {
+  TestGroup *group;
+  // test sprint_hex()
+  if (test_group(t, &group, string("sprint_hex()"), 1)) {
+    TEST(u64, string);
+    Test tests[] = {
+      {0, string("0x0")},
+      {0xA, string("0xA")},
+      {0x10, string("0x10")},
+      {0x0123456789ABCDEF, string("0x123456789ABCDEF")},
+      {0xFEDCBA9876543210, string("0xFEDCBA9876543210")},
+      {MAX_u64, string("0xFFFFFFFFFFFFFFFF")},
+    };
+    for (iptr i = 0; i < countof(tests); i++) {
+      Test test = tests[i];
+      byte buffer[sprint_size_hex(u64)];
+      byte *buffer_end = buffer + sizeof(buffer);
+      usize size = sprint_hex(test.in, buffer_end);
+      check(t, group, str_equals((string){(rcstring)(buffer_end - size), size}, test.out), u64, test.in);
+    }
+  }
+  test_summary(t, group);
+  // test sprint_uptr()
+  if (test_group(t, &group, string("sprint_uptr()"), 1)) {
+    TEST(u64, string);
+    Test tests[] = {
+      {0, string("0x0000000000000000")},
+      {0x0123456789ABCDEF, string("0x0123456789ABCDEF")},
+      {MAX_u64, string("0xFFFFFFFFFFFFFFFF")},
+    };
+    for (iptr i = 0; i < countof(tests); i++) {
+      Test test = tests[i];
+      byte buffer[sprint_size_uptr(uptr)];
+      byte *buffer_end = buffer + sizeof(buffer);
+      usize size = sprint_uptr(uptr(test.in), buffer_end);
+      check(t, group, str_equals((string){(rcstring)(buffer_end - size), size}, test.out), u64, test.in);
+    }
+  }
+  test_summary(t, group);
+  // test _sprint_hex_u8x16()
+  if (test_group(t, &group, string("_sprint_hex_u8x16()"), 1)) {
+    TEST(u64, string);
+    Test tests[] = {
+      {0, string("0000000000000000")},
+      {0x9, string("0000000000000009")},
+      {0xA0, string("00000000000000A0")},
+      {0x0123456789ABCDEF, string("0123456789ABCDEF")},
+      {0xFEDCBA9876543210, string("FEDCBA9876543210")},
+      {MAX_u64, string("FFFFFFFFFFFFFFFF")},
+    };
+    for (iptr i = 0; i < countof(tests); i++) {
+      Test test = tests[i];
+      /* NOTE: pshufb path if `__SSSE3__`, then the fallback, which is always compiled */
+      u8x16 digits = _sprint_hex_u8x16(test.in);
+      check(t, group, str_equals((string){(rcstring)&digits, 16}, test.out), u64, test.in);
+      u8x16 fallback_digits = _hex_digits_u8x16(_hex_nibbles_u8x16(test.in));
+      check(t, group, str_equals((string){(rcstring)&fallback_digits, 16}, test.out), u64, test.in);
+    }
+  }
+  test_summary(t, group);
+  // test sprint_hex_batch()
+  if (test_group(t, &group, string("sprint_hex_batch()"), 1)) {
+    u64 values[] = {0, MAX_u64, 0x0123456789ABCDEF};
+    string expected = string("0000000000000000"
+                             "FFFFFFFFFFFFFFFF"
+                             "0123456789ABCDEF");
+    /* NOTE: an odd count, with a guard byte on each side */
+    byte buffer[1 + 16 * countof(values) + 1];
+    buffer[0] = '#';
+    buffer[sizeof(buffer) - 1] = '#';
+    byte *buffer_end = buffer + sizeof(buffer) - 1;
+    usize count = usize(countof(values));
+    usize size = sprint_hex_batch(values, count, buffer_end);
+    check(t, group, size == 16 * count, u64, size);
+    check(t, group, str_equals((string){(rcstring)(buffer_end - size), size}, expected), u64, size);
+    check(t, group, buffer[0] == '#' && buffer[sizeof(buffer) - 1] == '#', u64, size);
+    check(t, group, sprint_hex_batch(values, 0, buffer_end) == 0, u64, 0);
+  }
+  test_summary(t, group);
+  // test with_arena()
+  if (test_group(t, &group, string("with_arena()"), 1)) {
+    Arena arena = arena_init(1 << 16);
+    byte *start = arena.buffer_next;
+    with_arena(&arena) {
+      arena_alloc_array(&arena, u64, 3);
+      byte *outer = arena.buffer_next;
+      with_arena(&arena) {
+        arena_alloc_array(&arena, byte, 5);
+        byte *inner = arena.buffer_next;
+        with_arena(&arena) {
+          /* NOTE: `buffer_next` is unaligned here, so this pads before allocating */
+          arena_alloc_array(&arena, u64, 100);
+        }
+        check(t, group, arena.buffer_next == inner, u64, u64(arena.buffer_next - start));
+        with_arena(&arena) {
+          arena_alloc_array(&arena, byte, 1);
+        }
+        check(t, group, arena.buffer_next == inner, u64, u64(arena.buffer_next - start));
+      }
+      check(t, group, arena.buffer_next == outer, u64, u64(arena.buffer_next - start));
+    }
+    check(t, group, arena.buffer_next == start, u64, u64(arena.buffer_next - start));
+    arena_free(&arena);
+  }
+  test_summary(t, group);
+  // test task_spawn(), task_scheduler_run()
+  if (test_group(t, &group, string("task_scheduler_run()"), 0)) {
+    task_scheduler_init(t);
+    Thread thread_count = global_threads.thread_infos[t].threads_end - global_threads.thread_infos[t].threads_start;
+    for (iptr round = 0; round < 20; round++) {
+      for (uptr id = t; id < TEST_TASK_COUNT; id += thread_count) {
+        atomic_store(&test_task_run_counts[id], 0);
+      }
+      /* NOTE: one thread spawns the root, so the others have to steal everything */
+      barrier(t);
+      if (single_core(t)) {
+        task_spawn(t, test_task, rawptr(uptr(0)));
+      }
+      task_scheduler_run(t);
+      /* NOTE: every thread returns, and every task ran exactly once */
+      u64 *returned = barrier_gather(t, 1);
+      Thread threads_start = global_threads.thread_infos[t].threads_start;
+      for (Thread i = 0; i < thread_count; i++) {
+        check(t, group, returned[threads_start + i] == 1, u64, i);
+      }
+      bool is_once = true;
+      for (uptr id = 0; id < TEST_TASK_COUNT; id++) {
+        is_once = is_once && atomic_load(&test_task_run_counts[id]) == 1;
+      }
+      check(t, group, is_once, i64, round);
+      barrier(t); /* NOTE: make sure all threads have checked, before the next round resets the counts */
+    }
+  }
+  test_summary(t, group);
+  // test parallel_for()
+  if (test_group(t, &group, string("parallel_for()"), 0)) {
+    Thread thread_count = global_threads.thread_infos[t].threads_end - global_threads.thread_infos[t].threads_start;
+    /* NOTE: {begin, end, grain}, where `(end - begin) % grain != 0` except for the empty range and `grain == 1` */
+    iptr ranges[][3] = {
+      {0, TEST_PARALLEL_FOR_SIZE, 1},
+      {8, TEST_PARALLEL_FOR_SIZE, 3},
+      {7, TEST_PARALLEL_FOR_SIZE - 2, 64},
+      {1, 100, 1000},
+      {500, 500, 8},
+      {999, TEST_PARALLEL_FOR_SIZE, 5},
+    };
+    /* NOTE: twice, so we also check that the claim counter is reset between loops */
+    for (iptr k = 0; k < 2 * countof(ranges); k++) {
+      iptr begin = ranges[k % countof(ranges)][0];
+      iptr end = ranges[k % countof(ranges)][1];
+      iptr grain = ranges[k % countof(ranges)][2];
+      for (uptr i = t; i < TEST_PARALLEL_FOR_SIZE; i += thread_count) {
+        atomic_store(&test_parallel_for_counts[i], 0);
+      }
+      barrier(t);
+      parallel_for(t, i, begin, end, grain) {
+        atomic_add_fetch(&test_parallel_for_counts[i], 1);
+      }
+      /* NOTE: parallel_for() ends with a barrier(), so every index in `[begin, end)` ran exactly once, and no others ran */
+      bool is_once = true;
+      for (iptr i = 0; i < TEST_PARALLEL_FOR_SIZE; i++) {
+        u32 expected = i >= begin && i < end ? 1 : 0;
+        is_once = is_once && atomic_load(&test_parallel_for_counts[i]) == expected;
+      }
+      check(t, group, is_once, i64, k);
+      barrier(t); /* NOTE: make sure all threads have checked, before the next range resets the counts */
+    }
+    /* NOTE: the body can't call single_core() or barrier_scatter(), so pick the next range between loops */
+    for (iptr k = 0; k < 20; k++) {
+      for (uptr i = t; i < TEST_PARALLEL_FOR_SIZE; i += thread_count) {
+        atomic_store(&test_parallel_for_counts[i], 0);
+      }
+      iptr end = 0;
+      if (single_core(t)) {
+        end = TEST_PARALLEL_FOR_SIZE - k * 37;
+      }
+      barrier_scatter(t, &end);
+      parallel_for(t, i, 0, end, k + 1) {
+        atomic_add_fetch(&test_parallel_for_counts[i], 1);
+      }
+      bool is_once = true;
+      for (iptr i = 0; i < TEST_PARALLEL_FOR_SIZE; i++) {
+        u32 expected = i < end ? 1 : 0;
+        is_once = is_once && atomic_load(&test_parallel_for_counts[i]) == expected;
+      }
+      check(t, group, is_once, i64, k);
+      barrier(t);
+    }
+  }
+  test_summary(t, group);
+}
@@ -366,8 +366,8 @@ ASSERT(sizeof(bf16) == 2);
 /* NOTE: __builtin_alloca() produces 6 instructions the first time, or 3 when reusing the same size */
 #define with_stack_allocator(stack)
 #define stack_alloc(stack, t)                      (t *)__builtin_alloca_with_align(sizeof(t), alignof_bits(t))
-#define stack_alloc_array(stack, t, count)         (t *)__builtin_alloca_with_align(sizeof(t) * count, alignof_bits(t))
-#define stack_alloc_flexible(stack, t1, t2, count) (t1 *)__builtin_alloca_with_align(sizeof(t1) + sizeof(t2) * count, alignof_bits(t))
+#define stack_alloc_array(stack, t, count)         (t *)__builtin_alloca_with_align(sizeof(t) * (count), alignof_bits(t))
+#define stack_alloc_flexible(stack, t1, t2, count) (t1 *)__builtin_alloca_with_align(sizeof(t1) + sizeof(t2) * (count), alignof_bits(t))
 
 #define bitcast(value, t1, t2)         bitcast_impl(__COUNTER__, value, t1, t2)
 #define bitcast_impl(C, value, t1, t2) ({ \
@@ -429,6 +429,8 @@ ASSERT(__atomic_always_lock_free(sizeof(u8), 0));
 // bits: https://gcc.gnu.org/onlinedocs/gcc/Bit-Operation-Builtins.html
 #define index_first_one_floor(t, x) (t)((sizeof_bits(t) - 1) - (t)__builtin_clzg((t)(x)))
 #define index_first_one_ceil(t, x)  (t)(index_first_one_floor(((t)(x) - 1) << 1));
+#define count_leading_zeros(t, x)   (t)(__builtin_clzg((t)(x), (int)sizeof_bits(t)))
+#define count_trailing_zeros(t, x)  (t)(__builtin_ctzg((t)(x), (int)sizeof_bits(t)))
 #define count_ones(t, x)            (t)(__builtin_popcountg((t)(x)))
 #define count_zeros(t, x)           (t)(__builtin_popcountg(~(t)(x)))
 #define count_parity(t, x)          (count_ones(t, x) & 1)
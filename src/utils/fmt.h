@@ -82,13 +82,39 @@ usize sprint_bool(bool value, byte *buffer_end) {
 #define sprint_size_u16(value)  (5)
 #define sprint_size_u8(value)   (3)
 #define sprint_size_byte(value) (3)
+/* NOTE: "00".."99", so we can print two digits per division */
+byte *DIGIT_PAIRS =
+  "0001020304050607080910111213141516171819"
+  "2021222324252627282930313233343536373839"
+  "4041424344454647484950515253545556575859"
+  "6061626364656667686970717273747576777879"
+  "8081828384858687888990919293949596979899";
 usize sprint_u64(u64 value, byte *buffer_end) {
   isize i = 0;
-  do {
-    isize digit = value % 10;
-    value = value / 10;
-    buffer_end[--i] = '0' + (byte)digit;
-  } while (value != 0);
+  /* NOTE: the compiler turns `/ 10000` and `/ 100` into a multiply and shift */
+  while (value >= 10000) {
+    u64 low = value % 10000;
+    value = value / 10000;
+    u64 pair_low = (low % 100) * 2;
+    u64 pair_high = (low / 100) * 2;
+    buffer_end[--i] = DIGIT_PAIRS[pair_low + 1];
+    buffer_end[--i] = DIGIT_PAIRS[pair_low];
+    buffer_end[--i] = DIGIT_PAIRS[pair_high + 1];
+    buffer_end[--i] = DIGIT_PAIRS[pair_high];
+  }
+  while (value >= 100) {
+    u64 pair = (value % 100) * 2;
+    value = value / 100;
+    buffer_end[--i] = DIGIT_PAIRS[pair + 1];
+    buffer_end[--i] = DIGIT_PAIRS[pair];
+  }
+  if (value >= 10) {
+    u64 pair = value * 2;
+    buffer_end[--i] = DIGIT_PAIRS[pair + 1];
+    buffer_end[--i] = DIGIT_PAIRS[pair];
+  } else {
+    buffer_end[--i] = '0' + (byte)value;
+  }
   return usize(-i);
 }
 usize sprint_u32(u32 value, byte *buffer_end) {
@@ -131,13 +157,33 @@ usize sprint_i8(i8 value, byte *buffer_end) {
 
 #define sprint_size_uptr(value) (2 + 2 * sizeof(uptr))
 byte *HEX_DIGITS = "0123456789ABCDEF";
+typedef u8 u8x16 vector_size(16) alignto(1);
+typedef byte bytex16 vector_size(16) alignto(1);
+typedef u64 u64x2 vector_size(16) alignto(1);
+/* NOTE: the 16 nibbles of `value`, most significant first */
+u8x16 _hex_nibbles_u8x16(u64 value) {
+  u8x16 bytes = (u8x16)((u64x2){__builtin_bswap64(value), 0});
+  u8x16 high = bytes >> 4;
+  u8x16 low = bytes & 0xf;
+  return __builtin_shufflevector(high, low, 0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23);
+}
+/* NOTE: fallback without pshufb, `'A' - ('9' + 1) == 7` */
+u8x16 _hex_digits_u8x16(u8x16 nibbles) {
+  return nibbles + '0' + ((u8x16)(nibbles > 9) & 7);
+}
+/* NOTE: all 16 hex digits of `value`, most significant first */
+u8x16 _sprint_hex_u8x16(u64 value) {
+  u8x16 nibbles = _hex_nibbles_u8x16(value);
+#if __SSSE3__
+  bytex16 lut = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'};
+  return (u8x16)__builtin_ia32_pshufb128(lut, (bytex16)nibbles);
+#else
+  return _hex_digits_u8x16(nibbles);
+#endif
+}
 usize sprint_uptr(uptr value, byte *buffer_end) {
-  isize i = 0;
-  do {
-    uptr digit = value & 0xf;
-    value = value >> 4;
-    buffer_end[--i] = HEX_DIGITS[digit];
-  } while (i > -2 * isize(sizeof(u64)));
+  *(u8x16 *)(buffer_end - 16) = _sprint_hex_u8x16(u64(value));
+  isize i = -16;
   buffer_end[--i] = 'x';
   buffer_end[--i] = '0';
   return usize(-i);
@@ -145,16 +191,21 @@ usize sprint_uptr(uptr value, byte *buffer_end) {
 #define sprint_size_hex(value)        (2 + 2 * sizeof(u64))
 #define sprint_hex(value, buffer_end) sprint_hex_impl((u64)value, buffer_end)
 usize sprint_hex_impl(u64 value, byte *buffer_end) {
-  isize i = 0;
-  do {
-    u64 digit = value & 0xf;
-    value = value >> 4;
-    buffer_end[--i] = HEX_DIGITS[digit];
-  } while (value != 0);
+  /* NOTE: we write all 16 digits, but only keep the significant ones */
+  *(u8x16 *)(buffer_end - 16) = _sprint_hex_u8x16(value);
+  isize i = value == 0 ? -1 : -isize((64 - __builtin_clzll(value) + 3) / 4);
   buffer_end[--i] = 'x';
   buffer_end[--i] = '0';
   return usize(-i);
 }
+/* print `count` values as 16 hex digits each, without prefixes */
+usize sprint_hex_batch(readonly u64 *values, usize count, byte *buffer_end) {
+  byte *buffer = buffer_end - 16 * count;
+  for (usize j = 0; j < count; j++) {
+    *(u8x16 *)(buffer + 16 * j) = _sprint_hex_u8x16(values[j]);
+  }
+  return 16 * count;
+}
 
 #define sprint_size_usize(value) sprint_size_u64(value)
 usize sprint_usize(usize value, byte *buffer_end) {
@@ -1,5 +1,7 @@
 #pragma once
-#include "builtin.h"
+#include "mem.h"
+#include "fmt.h"
+#include "threads.h"
 
 // Integer slice
 STRUCT(Integer) {
@@ -7,65 +9,16 @@ STRUCT(Integer) {
   u64 *chunks;
   u64 chunks_size;
 };
-#define integer_stack_alloc(stack, size)        ((Integer){stack_alloc_array(stack, u64, size), size})
+/* NOTE: functions that need temporaries take a `scratch` arena, and free them before returning */
+#define integer_arena_alloc(arena, size)        ((Integer){arena_alloc_array(arena, u64, size), size})
 #define integer_sign_extension(a)               (a.chunks[a.chunks_size - 1] >> 63 ? u64(-1) : 0)
 #define integer_get_chunk(a, i, sign_extension) (i < a.chunks_size ? a.chunks[i] : sign_extension)
 
 /* NOTE: we can't use `restrict`, as we sometimes want to do stuff like `x += y` */
-void integer_shift_left(Integer *result, Integer a, usize shift) {
-  u64 chunks_size = result->chunks_size;
-  // zero
-  usize i = 0;
-  usize j = shift / 64;
-  do {
-    result->chunks[i++] = 0;
-  } while (i < j && i < chunks_size);
-  // shift
-  u64 shift_end = min(chunks_size, u64(j) + a.chunks_size);
-  u64 carry = 0;
-  u64 remaining_shift = shift % 64;
-  while (i < shift_end) {
-    // TODO: compiler is not smart enough to simdize this, can we do it ourselves? */
-    u64 a_chunk = a.chunks[j++];
-    result->chunks[i++] = (a_chunk << remaining_shift) | carry;
-    carry = a_chunk >> (64 - remaining_shift);
-  }
-  // sign extend
-  u64 sign_extension = integer_sign_extension(a);
-  while (i < chunks_size) {
-    result->chunks[i++] = sign_extension;
-  }
-}
-void integer_shift_right(Integer *result, Integer a, usize shift, bool sign_extend) {
-  u64 chunks_size = result->chunks_size;
-  // sign extend
-  u64 sign_extension = integer_sign_extension(a);
-  if (!sign_extend) { sign_extension = 0; }
-  usize i = chunks_size;
-  usize j = a.chunks_size - (shift / 64);
-  usize sign_extend_end = max(j, 0);
-  do {
-    result->chunks[--i] = sign_extension;
-  } while (i > sign_extend_end);
-  // shift
-  u64 remaining_shift = shift % 64;
-  u64 carry = 0;
-  u64 shift_end = j < i ? u64(j - i) : 0;
-  while (i > shift_end) {
-    // TODO: compiler is not smart enough to simdize this, can we do it ourselves? */
-    u64 a_chunk = a.chunks[--j];
-    result->chunks[--i] = carry | (a_chunk >> remaining_shift);
-    carry = a_chunk << (64 - remaining_shift);
-  }
-  // zero
-  while (i > 0) {
-    result->chunks[--i] = 0;
-  }
-}
 void integer_copy(Integer *result, Integer a) {
   // copy
   usize i = 0;
-  u64 chunks_size = a.chunks_size;
+  u64 chunks_size = min(a.chunks_size, result->chunks_size);
   do {
     result->chunks[i] = a.chunks[i];
   } while (++i < chunks_size);
@@ -98,7 +51,7 @@ void integer_negate(Integer *result, Integer a) {
   // negate
   usize i = 0;
   u64 carry = 1;
-  u64 chunks_size = a.chunks_size;
+  u64 chunks_size = min(a.chunks_size, result->chunks_size);
   do {
     /* NOTE: add_overflow() cannot be unrolled */
     carry = (u64)add_overflow(~a.chunks[i], carry, &result->chunks[i]);
@@ -108,7 +61,8 @@ void integer_negate(Integer *result, Integer a) {
   chunks_size = result->chunks_size;
   u64 extension = ~integer_sign_extension(a);
   while (i < chunks_size) {
-    result->chunks[i++] = extension;
+    carry = (u64)add_overflow(extension, carry, &result->chunks[i]);
+    i++;
   }
 }
 #define integer_add_size(a, b) (max(a.chunks_size, b.chunks_size) + 1)
@@ -139,85 +93,1556 @@ void integer_sub(Integer *result, Integer a, Integer b) {
     result->chunks[i] = sub_with_borrow(a_chunk, b_chunk, borrow, &borrow);
   } while (++i < chunks_size);
 }
-#define _integer_karatsuba_mul_size(a, b) (a.chunks_size == 1 ? 2 : a.chunks_size * 2)
-void _integer_karatsuba_mul(Integer *result, Integer a, Integer b) {
-  // assert(a.chunks_size == b.chunks_size && a.chunks_size != 0 && a.chunks_size is a power of two)
-  if (expect_near(a.chunks_size == 1)) {
-    __uint128_t result_128 = (__uint128_t)a.chunks[0] * (__uint128_t)b.chunks[0];
-    result->chunks[0] = result_128 & (u64)-1;
-    result->chunks[1] = u64(result_128 >> 64);
+// unsigned
+/* NOTE: these treat the chunks as an unsigned magnitude, and never sign extend */
+usize _integer_unsigned_size(Integer a) {
+  usize size = a.chunks_size;
+  while (size > 0 && a.chunks[size - 1] == 0) {
+    size--;
+  }
+  return size;
+}
+/* NOTE: returns -1, 0 or 1, ignoring leading zero chunks */
+i32 _integer_compare_unsigned(Integer a, Integer b) {
+  usize a_size = _integer_unsigned_size(a);
+  usize b_size = _integer_unsigned_size(b);
+  if (a_size != b_size) { return a_size < b_size ? -1 : 1; }
+  usize i = a_size;
+  while (i > 0) {
+    i--;
+    if (a.chunks[i] != b.chunks[i]) { return a.chunks[i] < b.chunks[i] ? -1 : 1; }
+  }
+  return 0;
+}
+/* NOTE: `result = a`, zero extended, where `a.chunks_size <= result.chunks_size` */
+void _integer_copy_unsigned(Integer result, Integer a) {
+  usize i = 0;
+  for (; i < a.chunks_size; i++) {
+    result.chunks[i] = a.chunks[i];
+  }
+  for (; i < result.chunks_size; i++) {
+    result.chunks[i] = 0;
+  }
+}
+/* NOTE: `result += a`, where `a.chunks_size <= result.chunks_size`, returns the carry */
+u64 _integer_add_to_unsigned(Integer result, Integer a) {
+  usize i = 0;
+  u64 carry = 0;
+  while (i < a.chunks_size) {
+    result.chunks[i] = add_with_carry(result.chunks[i], a.chunks[i], carry, &carry);
+    i++;
+  }
+  while (carry != 0 && i < result.chunks_size) {
+    carry = (u64)add_overflow(result.chunks[i], carry, &result.chunks[i]);
+    i++;
+  }
+  return carry;
+}
+/* NOTE: `result -= a`, where `a.chunks_size <= result.chunks_size`, returns the borrow */
+u64 _integer_sub_from_unsigned(Integer result, Integer a) {
+  usize i = 0;
+  u64 borrow = 0;
+  while (i < a.chunks_size) {
+    result.chunks[i] = sub_with_borrow(result.chunks[i], a.chunks[i], borrow, &borrow);
+    i++;
+  }
+  while (borrow != 0 && i < result.chunks_size) {
+    borrow = (u64)sub_overflow(result.chunks[i], borrow, &result.chunks[i]);
+    i++;
+  }
+  return borrow;
+}
+/* NOTE: `result[0 : a.chunks_size] += a * b`, returns the carry chunk */
+u64 _integer_mul_add_u64_unsigned(Integer result, Integer a, u64 b) {
+  u64 carry = 0;
+  for (usize i = 0; i < a.chunks_size; i++) {
+    u128 product = u128(a.chunks[i]) * b + result.chunks[i] + carry;
+    result.chunks[i] = u64(product);
+    carry = u64(product >> 64);
+  }
+  return carry;
+}
+/* NOTE: `result[0 : a.chunks_size] = a * b`, `result` may alias `a`, returns the carry chunk */
+u64 _integer_mul_u64_unsigned(Integer result, Integer a, u64 b) {
+  u64 carry = 0;
+  for (usize i = 0; i < a.chunks_size; i++) {
+    u128 product = u128(a.chunks[i]) * b + carry;
+    result.chunks[i] = u64(product);
+    carry = u64(product >> 64);
+  }
+  return carry;
+}
+/* NOTE: `result[0 : a.chunks_size] -= a * b`, returns the borrow chunk */
+u64 _integer_mul_sub_u64_unsigned(Integer result, Integer a, u64 b) {
+  u64 borrow = 0;
+  for (usize i = 0; i < a.chunks_size; i++) {
+    u128 product = u128(a.chunks[i]) * b + borrow;
+    u64 product_low = u64(product);
+    borrow = u64(product >> 64) + (u64)sub_overflow(result.chunks[i], product_low, &result.chunks[i]);
+  }
+  return borrow;
+}
+/* NOTE: the compiler is not smart enough to simdize the shifts, so we do it ourselves */
+#define INTEGER_SHIFT_LANES 4
+typedef u64 u64x4 vector_size(32) alignto(8);
+u64x4 _u64x4_load(readonly u64 *ptr) {
+  u64x4 value;
+  __builtin_memcpy(&value, ptr, sizeof(value));
+  return value;
+}
+void _u64x4_store(u64 *ptr, u64x4 value) {
+  __builtin_memcpy(ptr, &value, sizeof(value));
+}
+/* NOTE: `(high << shift) | (low >> (64 - shift))`, for `0 < shift < 64` */
+u64x4 _u64x4_funnel_shift_left(u64x4 high, u64x4 low, u64 shift) {
+#if __AVX512VBMI2__ && __AVX512VL__
+  u64x4 shifts = (u64x4){shift, shift, shift, shift};
+  asm("vpshldvq %0, %1, %2" : "+v"(high) : "v"(low), "v"(shifts));
+  return high;
+#else
+  return (high << shift) | (low >> (64 - shift));
+#endif
+}
+/* NOTE: `(low >> shift) | (high << (64 - shift))`, for `0 < shift < 64` */
+u64x4 _u64x4_funnel_shift_right(u64x4 high, u64x4 low, u64 shift) {
+#if __AVX512VBMI2__ && __AVX512VL__
+  u64x4 shifts = (u64x4){shift, shift, shift, shift};
+  asm("vpshrdvq %0, %1, %2" : "+v"(low) : "v"(high), "v"(shifts));
+  return low;
+#else
+  return (low >> shift) | (high << (64 - shift));
+#endif
+}
+/* NOTE: `result = a << shift`, where `shift < 64` and `result.chunks_size == a.chunks_size`, returns the shifted out bits,
+  `result` may alias `a`, or start after it */
+u64 _integer_shift_left_bits_unsigned(Integer result, Integer a, u64 shift) {
+  usize i = a.chunks_size;
+  if (i == 0) { return 0; }
+  /* NOTE: `x >> 64` is undefined, but `(x >> 1) >> 63` is 0 */
+  u64 carry = (a.chunks[i - 1] >> 1) >> (63 - shift);
+  if (shift == 0) {
+    while (i > 0) {
+      i--;
+      result.chunks[i] = a.chunks[i];
+    }
+    return carry;
+  }
+  /* NOTE: go down, so we never overwrite chunks we still need to read */
+  while (i > INTEGER_SHIFT_LANES) {
+    i -= INTEGER_SHIFT_LANES;
+    u64x4 high = _u64x4_load(&a.chunks[i]);
+    u64x4 low = _u64x4_load(&a.chunks[i - 1]);
+    _u64x4_store(&result.chunks[i], _u64x4_funnel_shift_left(high, low, shift));
+  }
+  while (i > 1) {
+    i--;
+    result.chunks[i] = (a.chunks[i] << shift) | (a.chunks[i - 1] >> (64 - shift));
+  }
+  result.chunks[0] = a.chunks[0] << shift;
+  return carry;
+}
+/* NOTE: `result = a >> shift`, where `shift < 64` and `result.chunks_size == a.chunks_size`,
+  `result` may alias `a`, or start before it */
+void _integer_shift_right_bits_unsigned(Integer result, Integer a, u64 shift) {
+  usize chunks_size = a.chunks_size;
+  if (chunks_size == 0) { return; }
+  usize i = 0;
+  if (shift == 0) {
+    for (; i < chunks_size; i++) {
+      result.chunks[i] = a.chunks[i];
+    }
+    return;
+  }
+  /* NOTE: go up, so we never overwrite chunks we still need to read */
+  for (; i + INTEGER_SHIFT_LANES < chunks_size; i += INTEGER_SHIFT_LANES) {
+    u64x4 high = _u64x4_load(&a.chunks[i + 1]);
+    u64x4 low = _u64x4_load(&a.chunks[i]);
+    _u64x4_store(&result.chunks[i], _u64x4_funnel_shift_right(high, low, shift));
+  }
+  for (; i + 1 < chunks_size; i++) {
+    result.chunks[i] = (a.chunks[i] >> shift) | (a.chunks[i + 1] << (64 - shift));
+  }
+  result.chunks[chunks_size - 1] = a.chunks[chunks_size - 1] >> shift;
+}
+
+// shifts
+/* NOTE: `result = a << shift`, `result` may alias `a` */
+void integer_shift_left(Integer *result, Integer a, usize shift) {
+  usize chunks_size = result->chunks_size;
+  usize chunk_shift = shift / 64;
+  u64 bit_shift = shift % 64;
+  u64 sign_extension = integer_sign_extension(a);
+  if (chunk_shift >= chunks_size) {
+    chunk_shift = chunks_size;
   } else {
-    usize split = a.chunks_size / 2;
-    Integer A = (Integer){a.chunks + split, u64(split)};
-    Integer C = (Integer){a.chunks, u64(split)};
-    Integer B = (Integer){b.chunks + split, u64(split)};
-    Integer D = (Integer){b.chunks, u64(split)};
+    // shift
+    usize shifted_size = min(a.chunks_size, chunks_size - chunk_shift);
+    Integer result_slice = (Integer){&result->chunks[chunk_shift], shifted_size};
+    u64 carry = _integer_shift_left_bits_unsigned(result_slice, (Integer){a.chunks, shifted_size}, bit_shift);
+    // sign extend
+    usize i = chunk_shift + shifted_size;
+    if (i < chunks_size) {
+      result->chunks[i++] = (sign_extension << bit_shift) | carry;
+    }
+    while (i < chunks_size) {
+      result->chunks[i++] = sign_extension;
+    }
+  }
+  // zero
+  for (usize i = 0; i < chunk_shift; i++) {
+    result->chunks[i] = 0;
+  }
+}
+/* NOTE: `result = a >> shift`, filling with the sign if `sign_extend`, or with zeros otherwise, `result` may alias `a` */
+void integer_shift_right(Integer *result, Integer a, usize shift, bool sign_extend) {
+  usize chunks_size = result->chunks_size;
+  usize chunk_shift = shift / 64;
+  u64 bit_shift = shift % 64;
+  u64 sign_extension = sign_extend ? integer_sign_extension(a) : 0;
+  usize i = 0;
+  if (chunk_shift < a.chunks_size) {
+    // shift
+    usize shifted_size = min(a.chunks_size - chunk_shift, chunks_size);
+    u64 next_chunk = chunk_shift + shifted_size < a.chunks_size ? a.chunks[chunk_shift + shifted_size] : sign_extension;
+    _integer_shift_right_bits_unsigned((Integer){result->chunks, shifted_size}, (Integer){&a.chunks[chunk_shift], shifted_size}, bit_shift);
+    result->chunks[shifted_size - 1] |= (next_chunk << 1) << (63 - bit_shift);
+    i = shifted_size;
+  }
+  // sign extend
+  while (i < chunks_size) {
+    result->chunks[i++] = sign_extension;
+  }
+}
+
+// multiplication
+/* NOTE: thresholds on the smaller operand, in chunks, measured on x64 */
+#ifndef INTEGER_KARATSUBA_THRESHOLD
+  #define INTEGER_KARATSUBA_THRESHOLD 32
+#endif
+#ifndef INTEGER_TOOM3_THRESHOLD
+  #define INTEGER_TOOM3_THRESHOLD 192
+#endif
+#ifndef INTEGER_NTT_THRESHOLD
+  #define INTEGER_NTT_THRESHOLD 32768
+#endif
+/* NOTE: `result.chunks_size == a.chunks_size + b.chunks_size`, `result` must not alias `a` or `b` */
+void _integer_mul_schoolbook_unsigned(Integer result, Integer a, Integer b) {
+  for (usize i = 0; i < a.chunks_size; i++) {
+    result.chunks[i] = 0;
+  }
+  for (usize i = 0; i < b.chunks_size; i++) {
+    Integer result_slice = (Integer){&result.chunks[i], a.chunks_size};
+    result.chunks[i + a.chunks_size] = _integer_mul_add_u64_unsigned(result_slice, a, b.chunks[i]);
+  }
+}
+void _integer_mul_unsigned(Arena *scratch, Integer result, Integer a, Integer b);
+void integer_mul(Arena *scratch, Integer *result, Integer a, Integer b);
+/* NOTE: for `a.chunks_size >= 2 * b.chunks_size`, multiply `b.chunks_size` sized pieces of `a` by `b` */
+void _integer_mul_unbalanced_unsigned(Arena *scratch, Integer result, Integer a, Integer b) {
+  for (usize i = 0; i < result.chunks_size; i++) {
+    result.chunks[i] = 0;
+  }
+  with_arena(scratch) {
+    Integer product = integer_arena_alloc(scratch, b.chunks_size * 2);
+    for (usize offset = 0; offset < a.chunks_size; offset += b.chunks_size) {
+      Integer a_piece = (Integer){&a.chunks[offset], min(b.chunks_size, a.chunks_size - offset)};
+      Integer product_slice = (Integer){product.chunks, a_piece.chunks_size + b.chunks_size};
+      _integer_mul_unsigned(scratch, product_slice, a_piece, b);
+      Integer result_slice = (Integer){&result.chunks[offset], result.chunks_size - offset};
+      _integer_add_to_unsigned(result_slice, product_slice);
+    }
+  }
+}
+/* NOTE: `a.chunks_size >= b.chunks_size > ceil(a.chunks_size / 2)` */
+void _integer_karatsuba_mul_unsigned(Arena *scratch, Integer result, Integer a, Integer b) {
+  /* NOTE: `a*b = A*B*2^(128*split) + ((A+C)*(B+D) - A*B - C*D)*2^(64*split) + C*D` */
+  usize split = (a.chunks_size + 1) / 2;
+  Integer A = (Integer){a.chunks + split, a.chunks_size - split};
+  Integer C = (Integer){a.chunks, split};
+  Integer B = (Integer){b.chunks + split, b.chunks_size - split};
+  Integer D = (Integer){b.chunks, split};
+  Integer result_0 = (Integer){result.chunks, split * 2};
+  _integer_mul_unsigned(scratch, result_0, C, D);
+  Integer result_2 = (Integer){result.chunks + split * 2, result.chunks_size - split * 2};
+  _integer_mul_unsigned(scratch, result_2, A, B);
+  with_arena(scratch) {
+    Integer result_ApC = integer_arena_alloc(scratch, u64(split) + 1);
+    _integer_copy_unsigned(result_ApC, C);
+    result_ApC.chunks[split] = _integer_add_to_unsigned((Integer){result_ApC.chunks, split}, A);
+    Integer result_BpD = integer_arena_alloc(scratch, u64(split) + 1);
+    _integer_copy_unsigned(result_BpD, D);
+    result_BpD.chunks[split] = _integer_add_to_unsigned((Integer){result_BpD.chunks, split}, B);
+    Integer result_1 = integer_arena_alloc(scratch, (u64(split) + 1) * 2);
+    _integer_mul_unsigned(scratch, result_1, result_ApC, result_BpD);
+    _integer_sub_from_unsigned(result_1, result_0);
+    _integer_sub_from_unsigned(result_1, result_2);
+    // merge result_1
+    result_1.chunks_size = _integer_unsigned_size(result_1);
+    _integer_add_to_unsigned((Integer){result.chunks + split, result.chunks_size - split}, result_1);
+  }
+}
 
-    with_stack_allocator(stack) {
-      Integer result_0 = integer_stack_alloc(stack, a.chunks_size);
-      _integer_karatsuba_mul(&result_0, C, D);
+// Toom-3
+/* NOTE: exact division by 3, also works for negative numbers in two's complement (Jebelean 1993) */
+void _integer_divexact_3(Integer a) {
+  u64 borrow = 0;
+  for (usize i = 0; i < a.chunks_size; i++) {
+    u64 difference;
+    u64 next_borrow = (u64)sub_overflow(a.chunks[i], borrow, &difference);
+    /* NOTE: 3 * 0xAAAAAAAAAAAAAAAB == 1 (mod 2^64) */
+    u64 q = difference * 0xAAAAAAAAAAAAAAABULL;
+    a.chunks[i] = q;
+    borrow = u64((u128(q) * 3) >> 64) + next_borrow;
+  }
+}
+/* NOTE: exact division by 2, preserving the sign */
+void _integer_half_exact(Integer a) {
+  u64 sign = a.chunks[a.chunks_size - 1] & (u64(1) << 63);
+  _integer_shift_right_bits_unsigned(a, a, 1);
+  a.chunks[a.chunks_size - 1] |= sign;
+}
+/* NOTE: evaluates `x0 + x1*t + x2*t^2` at `t = 1, -1, -2`, each result has `x0.chunks_size` chunks */
+void _integer_toom3_evaluate(Integer at_1, Integer at_m1, Integer at_m2, Integer x0, Integer x1, Integer x2) {
+  integer_add(&at_m2, x0, x2);
+  integer_add(&at_1, at_m2, x1);
+  integer_sub(&at_m1, at_m2, x1);
+  integer_add(&at_m2, at_m1, x2);
+  integer_add(&at_m2, at_m2, at_m2);
+  integer_sub(&at_m2, at_m2, x0);
+}
+/* NOTE: Towards Optimal Toom-Cook Multiplication for Univariate and Multivariate Polynomials in Characteristic 2 and 0 (Bodrato 2007)
+  evaluates at `{0, 1, -1, -2, inf}` with signed temporaries,
+  `a.chunks_size >= b.chunks_size > 2 * ceil(a.chunks_size / 3)` */
+void _integer_toom3_mul_unsigned(Arena *scratch, Integer result, Integer a, Integer b) {
+  usize k = (a.chunks_size + 2) / 3;
+  /* NOTE: `|x0 - 2*x1 + 4*x2| < 7 * 2^(64*k)`, so `k + 1` chunks fit every evaluation */
+  usize eval_size = k + 1;
+  usize product_size = eval_size * 2;
+  with_arena(scratch) {
+    // split
+    Integer a_0 = integer_arena_alloc(scratch, eval_size);
+    Integer a_1 = integer_arena_alloc(scratch, eval_size);
+    Integer a_2 = integer_arena_alloc(scratch, eval_size);
+    _integer_copy_unsigned(a_0, (Integer){a.chunks, k});
+    _integer_copy_unsigned(a_1, (Integer){a.chunks + k, k});
+    _integer_copy_unsigned(a_2, (Integer){a.chunks + k * 2, a.chunks_size - k * 2});
+    Integer b_0 = integer_arena_alloc(scratch, eval_size);
+    Integer b_1 = integer_arena_alloc(scratch, eval_size);
+    Integer b_2 = integer_arena_alloc(scratch, eval_size);
+    _integer_copy_unsigned(b_0, (Integer){b.chunks, k});
+    _integer_copy_unsigned(b_1, (Integer){b.chunks + k, k});
+    _integer_copy_unsigned(b_2, (Integer){b.chunks + k * 2, b.chunks_size - k * 2});
+    // evaluate
+    Integer a_at_1 = integer_arena_alloc(scratch, eval_size);
+    Integer a_at_m1 = integer_arena_alloc(scratch, eval_size);
+    Integer a_at_m2 = integer_arena_alloc(scratch, eval_size);
+    _integer_toom3_evaluate(a_at_1, a_at_m1, a_at_m2, a_0, a_1, a_2);
+    Integer b_at_1 = integer_arena_alloc(scratch, eval_size);
+    Integer b_at_m1 = integer_arena_alloc(scratch, eval_size);
+    Integer b_at_m2 = integer_arena_alloc(scratch, eval_size);
+    _integer_toom3_evaluate(b_at_1, b_at_m1, b_at_m2, b_0, b_1, b_2);
+    // multiply
+    Integer r_0 = integer_arena_alloc(scratch, product_size);
+    integer_mul(scratch, &r_0, a_0, b_0);
+    Integer r_1 = integer_arena_alloc(scratch, product_size);
+    integer_mul(scratch, &r_1, a_at_1, b_at_1);
+    Integer r_2 = integer_arena_alloc(scratch, product_size);
+    integer_mul(scratch, &r_2, a_at_m1, b_at_m1);
+    Integer r_3 = integer_arena_alloc(scratch, product_size);
+    integer_mul(scratch, &r_3, a_at_m2, b_at_m2);
+    Integer r_4 = integer_arena_alloc(scratch, product_size);
+    integer_mul(scratch, &r_4, a_2, b_2);
+    // interpolate
+    integer_sub(&r_3, r_3, r_1);
+    _integer_divexact_3(r_3);
+    integer_sub(&r_1, r_1, r_2);
+    _integer_half_exact(r_1);
+    integer_sub(&r_2, r_2, r_0);
+    integer_sub(&r_3, r_2, r_3);
+    _integer_half_exact(r_3);
+    integer_add(&r_3, r_3, r_4);
+    integer_add(&r_3, r_3, r_4);
+    integer_add(&r_2, r_2, r_1);
+    integer_sub(&r_2, r_2, r_4);
+    integer_sub(&r_1, r_1, r_3);
+    // recompose
+    for (usize i = 0; i < result.chunks_size; i++) {
+      result.chunks[i] = 0;
+    }
+    Integer coefficients[] = {r_0, r_1, r_2, r_3, r_4};
+    for (usize i = 0; i < 5; i++) {
+      /* NOTE: the coefficients of the product are non-negative */
+      Integer coefficient = coefficients[i];
+      coefficient.chunks_size = _integer_unsigned_size(coefficient);
+      _integer_add_to_unsigned((Integer){result.chunks + k * i, result.chunks_size - k * i}, coefficient);
+    }
+  }
+}
 
-      Integer result_2 = integer_stack_alloc(stack, a.chunks_size);
-      _integer_karatsuba_mul(&result_2, A, B);
+// NTT
+/* NOTE: number theoretic transform modulo the "Goldilocks" prime `p = 2^64 - 2^32 + 1`,
+  using 16-bit digits, so each coefficient of the product is `< 2^32 * n < p` for any `n <= 2^32` */
+#define NTT_PRIME     0xFFFFFFFF00000001ULL
+#define NTT_EPSILON   0x00000000FFFFFFFFULL /* NOTE: 2^64 mod p */
+#define NTT_GENERATOR 7
+#define NTT_MAX_SIZE  (u64(1) << 32)
+/* NOTE: these are branchless, since the branches are unpredictable */
+u64 _ntt_add(u64 a, u64 b) {
+  u64 sum;
+  u64 carry = (u64)add_overflow(a, b, &sum);
+  /* NOTE: `sum + 2^64 - p = sum + NTT_EPSILON` */
+  sum += NTT_EPSILON & -carry;
+  sum -= NTT_PRIME & -(u64)(sum >= NTT_PRIME);
+  return sum;
+}
+u64 _ntt_sub(u64 a, u64 b) {
+  u64 difference;
+  u64 borrow = (u64)sub_overflow(a, b, &difference);
+  return difference + (NTT_PRIME & -borrow);
+}
+u64 _ntt_mul(u64 a, u64 b) {
+  /* NOTE: `2^64 = 2^32 - 1` and `2^96 = -1` (mod p) */
+  u128 product = u128(a) * b;
+  u64 low = u64(product);
+  u64 high = u64(product >> 64);
+  u64 high_high = high >> 32;
+  u64 high_low = high & NTT_EPSILON;
+  u64 t0;
+  u64 borrow = (u64)sub_overflow(low, high_high, &t0);
+  t0 -= NTT_EPSILON & -borrow;
+  u64 t1 = (high_low << 32) - high_low;
+  u64 result;
+  u64 carry = (u64)add_overflow(t0, t1, &result);
+  result += NTT_EPSILON & -carry;
+  result -= NTT_PRIME & -(u64)(result >= NTT_PRIME);
+  return result;
+}
+u64 _ntt_pow(u64 base, u64 exponent) {
+  u64 result = 1;
+  while (exponent != 0) {
+    if (exponent & 1) { result = _ntt_mul(result, base); }
+    base = _ntt_mul(base, base);
+    exponent >>= 1;
+  }
+  return result;
+}
+/* NOTE: in place radix-2 transform, `n` is a power of two, `roots` has `n / 2` elements of scratch space */
+void _ntt(u64 *values, u64 *roots, usize n, bool inverse) {
+  // bit reverse
+  for (usize i = 1, j = 0; i < n; i++) {
+    usize bit = n >> 1;
+    while (j & bit) {
+      j ^= bit;
+      bit >>= 1;
+    }
+    j ^= bit;
+    if (i < j) {
+      u64 tmp = values[i];
+      values[i] = values[j];
+      values[j] = tmp;
+    }
+  }
+  // butterflies
+  for (usize size = 2; size <= n; size <<= 1) {
+    usize half = size / 2;
+    u64 root = _ntt_pow(NTT_GENERATOR, (NTT_PRIME - 1) / size);
+    if (inverse) { root = _ntt_pow(root, NTT_PRIME - 2); }
+    roots[0] = 1;
+    for (usize j = 1; j < half; j++) {
+      roots[j] = _ntt_mul(roots[j - 1], root);
+    }
+    for (usize i = 0; i < n; i += size) {
+      for (usize j = 0; j < half; j++) {
+        u64 u = values[i + j];
+        u64 v = _ntt_mul(values[i + j + half], roots[j]);
+        values[i + j] = _ntt_add(u, v);
+        values[i + j + half] = _ntt_sub(u, v);
+      }
+    }
+  }
+  if (inverse) {
+    u64 n_inverse = _ntt_pow(n, NTT_PRIME - 2);
+    for (usize i = 0; i < n; i++) {
+      values[i] = _ntt_mul(values[i], n_inverse);
+    }
+  }
+}
+void _ntt_load_digits(u64 *values, usize n, Integer a) {
+  for (usize i = 0; i < n; i++) {
+    usize chunk = i / 4;
+    values[i] = chunk < a.chunks_size ? (a.chunks[chunk] >> (16 * (i % 4))) & 0xffff : 0;
+  }
+}
+/* NOTE: `result.chunks_size == a.chunks_size + b.chunks_size`, `result` must not alias `a` or `b` */
+void _integer_ntt_mul_unsigned(Arena *scratch, Integer result, Integer a, Integer b) {
+  usize digits = (a.chunks_size + b.chunks_size) * 4;
+  usize n = 1;
+  while (n < digits) {
+    n <<= 1;
+  }
+  assert(n <= NTT_MAX_SIZE);
+  bool is_square = a.chunks == b.chunks && a.chunks_size == b.chunks_size;
+  with_arena(scratch) {
+    u64 *a_values = arena_alloc_array(scratch, u64, n);
+    u64 *b_values = is_square ? a_values : arena_alloc_array(scratch, u64, n);
+    u64 *roots = arena_alloc_array(scratch, u64, n / 2);
+    // transform
+    _ntt_load_digits(a_values, n, a);
+    _ntt(a_values, roots, n, false);
+    if (!is_square) {
+      _ntt_load_digits(b_values, n, b);
+      _ntt(b_values, roots, n, false);
+    }
+    // multiply
+    for (usize i = 0; i < n; i++) {
+      a_values[i] = _ntt_mul(a_values[i], b_values[i]);
+    }
+    // transform back
+    _ntt(a_values, roots, n, true);
+    // carry
+    u128 carry = 0;
+    for (usize i = 0; i < result.chunks_size; i++) {
+      carry += u128(a_values[i * 4]);
+      carry += u128(a_values[i * 4 + 1]) << 16;
+      carry += u128(a_values[i * 4 + 2]) << 32;
+      carry += u128(a_values[i * 4 + 3]) << 48;
+      result.chunks[i] = u64(carry);
+      carry >>= 64;
+    }
+  }
+}
 
-      Integer result_ApC = integer_stack_alloc(stack, u64(split) + 1);
-      integer_add(&result_ApC, A, C);
-      Integer result_BpD = integer_stack_alloc(stack, u64(split) + 1);
-      integer_add(&result_BpD, B, D);
-      Integer result_1 = integer_stack_alloc(stack, (u64(split) + 1) * 2);
-      _integer_karatsuba_mul(&result_1, result_ApC, result_BpD);
-      integer_sub(&result_1, result_1, result_0);
-      integer_sub(&result_1, result_1, result_2);
-      // merge result_0
-      integer_copy(result, result_0);
-      // merge result_1
-      usize i = split;
-      u64 carry = 0;
-      u64 extension = integer_sign_extension(result_1);
-      u64 chunks_size = result->chunks_size;
-      do {
-        u64 result_1_chunk = integer_get_chunk(result_1, i - split, extension);
-        result->chunks[i] = add_with_carry(result->chunks[i], result_1_chunk, carry, &carry);
-      } while (++i < chunks_size);
-      // merge result_2
-      i = split * 2;
-      carry = 0;
-      extension = integer_sign_extension(result_2);
-      do {
-        u64 result_2_chunk = integer_get_chunk(result_2, i - split * 2, extension);
-        result->chunks[i] = add_with_carry(result->chunks[i], result_2_chunk, carry, &carry);
-      } while (++i < chunks_size);
-    }
-  }
-}
-#define integer_mul_size(a, b)         integer_mul_size_impl(__COUNTER__, a, b)
-#define integer_mul_size_impl(C, a, b) ({                                                    \
-  u64 VAR(max_chunks_size, C) = a.chunks_size + b.chunks_size;                               \
-  if (count_ones(u64, VAR(max_chunks_size, C)) > 1) {                                        \
-    VAR(max_chunks_size, C) = 1 << (64 - count_leading_zeros(u64, VAR(max_chunks_size, C))); \
-  }                                                                                          \
-  VAR(max_chunks_size, C);                                                                   \
-})
-void integer_mul(Integer *result, u64 size, Integer a, Integer b) {
-  with_stack_allocator(stack) {
-    Integer left = integer_stack_alloc(stack, size);
-    integer_copy(&left, a);
-    Integer right = integer_stack_alloc(stack, size);
-    integer_copy(&right, b);
-    _integer_karatsuba_mul(result, left, right);
-  }
-}
-Integer *integer_div(Integer *restrict a, Integer *restrict b) {
-  /* TODO:
-  - alloc(a) x2
-  - make b have opposite sign to a
-  - do long division
-  */
-  return 0;
+/* NOTE: `result.chunks_size == a.chunks_size + b.chunks_size`, `result` must not alias `a` or `b` */
+void _integer_mul_unsigned(Arena *scratch, Integer result, Integer a, Integer b) {
+  if (a.chunks_size < b.chunks_size) {
+    Integer tmp = a;
+    a = b;
+    b = tmp;
+  }
+  if (b.chunks_size < INTEGER_KARATSUBA_THRESHOLD) {
+    _integer_mul_schoolbook_unsigned(result, a, b);
+  } else if (b.chunks_size <= (a.chunks_size + 1) / 2) {
+    _integer_mul_unbalanced_unsigned(scratch, result, a, b);
+  } else if (b.chunks_size >= INTEGER_NTT_THRESHOLD) {
+    _integer_ntt_mul_unsigned(scratch, result, a, b);
+  } else if (b.chunks_size >= INTEGER_TOOM3_THRESHOLD && b.chunks_size > (a.chunks_size + 2) / 3 * 2) {
+    _integer_toom3_mul_unsigned(scratch, result, a, b);
+  } else {
+    _integer_karatsuba_mul_unsigned(scratch, result, a, b);
+  }
+}
+#define integer_mul_size(a, b) (a.chunks_size + b.chunks_size)
+void integer_mul(Arena *scratch, Integer *result, Integer a, Integer b) {
+  bool a_negative = integer_sign_extension(a) != 0;
+  bool b_negative = integer_sign_extension(b) != 0;
+  with_arena(scratch) {
+    // abs
+    Integer a_abs = integer_arena_alloc(scratch, integer_negate_size(a));
+    if (a_negative) {
+      integer_negate(&a_abs, a);
+    } else {
+      integer_copy(&a_abs, a);
+    }
+    Integer b_abs = integer_arena_alloc(scratch, integer_negate_size(b));
+    if (b_negative) {
+      integer_negate(&b_abs, b);
+    } else {
+      integer_copy(&b_abs, b);
+    }
+    a_abs.chunks_size = max(_integer_unsigned_size(a_abs), 1);
+    b_abs.chunks_size = max(_integer_unsigned_size(b_abs), 1);
+    // multiply
+    /* NOTE: the extra zero chunk keeps this non-negative in two's complement */
+    Integer product = integer_arena_alloc(scratch, a_abs.chunks_size + b_abs.chunks_size + 1);
+    product.chunks[product.chunks_size - 1] = 0;
+    _integer_mul_unsigned(scratch, (Integer){product.chunks, product.chunks_size - 1}, a_abs, b_abs);
+    // sign
+    if (a_negative != b_negative) {
+      integer_negate(result, product);
+    } else {
+      integer_copy(result, product);
+    }
+  }
+}
+
+// parallel multiplication
+/* NOTE: below this many chunks, the threads would spend more time waiting on each other than multiplying */
+#ifndef INTEGER_PARALLEL_MUL_THRESHOLD
+  #define INTEGER_PARALLEL_MUL_THRESHOLD 2048
+#endif
+STRUCT(IntegerMulParallelData) {
+  Integer a;
+  Integer b;
+  Integer product;
+  Integer result_ApC;
+  Integer result_BpD;
+  Integer result_1;
+  usize split;
+  bool is_negative;
+  bool is_parallel;
+};
+/* NOTE: call this from every thread in the group, with the same `result`, `a` and `b`, but a separate `scratch` per thread,
+  the 3 products of the top Karatsuba level run on 3 groups of threads */
+void integer_mul_parallel(Thread t, Arena *scratch, Integer *result, Integer a, Integer b) {
+  Thread threads_start = global_threads.thread_infos[t].threads_start;
+  Thread threads_end = global_threads.thread_infos[t].threads_end;
+  u32 thread_count = threads_end - threads_start;
+  // setup
+  bool is_first = single_core(t);
+  byte *mark = arena_mark(scratch);
+  IntegerMulParallelData *data = nil;
+  if (is_first) {
+    data = arena_alloc_type(scratch, IntegerMulParallelData);
+    bool a_negative = integer_sign_extension(a) != 0;
+    bool b_negative = integer_sign_extension(b) != 0;
+    data->is_negative = a_negative != b_negative;
+    // abs
+    Integer a_abs = integer_arena_alloc(scratch, integer_negate_size(a));
+    if (a_negative) {
+      integer_negate(&a_abs, a);
+    } else {
+      integer_copy(&a_abs, a);
+    }
+    Integer b_abs = integer_arena_alloc(scratch, integer_negate_size(b));
+    if (b_negative) {
+      integer_negate(&b_abs, b);
+    } else {
+      integer_copy(&b_abs, b);
+    }
+    a_abs.chunks_size = max(_integer_unsigned_size(a_abs), 1);
+    b_abs.chunks_size = max(_integer_unsigned_size(b_abs), 1);
+    if (a_abs.chunks_size < b_abs.chunks_size) {
+      Integer tmp = a_abs;
+      a_abs = b_abs;
+      b_abs = tmp;
+    }
+    data->a = a_abs;
+    data->b = b_abs;
+    /* NOTE: the extra zero chunk keeps this non-negative in two's complement */
+    data->product = integer_arena_alloc(scratch, a_abs.chunks_size + b_abs.chunks_size + 1);
+    data->product.chunks[data->product.chunks_size - 1] = 0;
+    // A+C, B+D
+    usize split = (a_abs.chunks_size + 1) / 2;
+    data->split = split;
+    data->is_parallel = thread_count >= 3 && b_abs.chunks_size >= INTEGER_PARALLEL_MUL_THRESHOLD && b_abs.chunks_size > split;
+    if (data->is_parallel) {
+      Integer A = (Integer){a_abs.chunks + split, a_abs.chunks_size - split};
+      Integer B = (Integer){b_abs.chunks + split, b_abs.chunks_size - split};
+      data->result_ApC = integer_arena_alloc(scratch, u64(split) + 1);
+      _integer_copy_unsigned(data->result_ApC, (Integer){a_abs.chunks, split});
+      data->result_ApC.chunks[split] = _integer_add_to_unsigned((Integer){data->result_ApC.chunks, split}, A);
+      data->result_BpD = integer_arena_alloc(scratch, u64(split) + 1);
+      _integer_copy_unsigned(data->result_BpD, (Integer){b_abs.chunks, split});
+      data->result_BpD.chunks[split] = _integer_add_to_unsigned((Integer){data->result_BpD.chunks, split}, B);
+      data->result_1 = integer_arena_alloc(scratch, (u64(split) + 1) * 2);
+    }
+  }
+  barrier_scatter(t, &data);
+  // multiply
+  Integer product = (Integer){data->product.chunks, data->product.chunks_size - 1};
+  usize split = data->split;
+  if (data->is_parallel) {
+    u32 group = 0;
+    if (!barrier_split_threads(t, thread_count / 3)) {
+      group = barrier_split_threads(t, (thread_count - thread_count / 3) / 2) ? 1 : 2;
+    }
+    /* NOTE: only the top level is split, so the other threads in each group just wait */
+    if (single_core(t)) {
+      Integer a_abs = data->a;
+      Integer b_abs = data->b;
+      if (group == 0) {
+        Integer result_0 = (Integer){product.chunks, split * 2};
+        _integer_mul_unsigned(scratch, result_0, (Integer){a_abs.chunks, split}, (Integer){b_abs.chunks, split});
+      } else if (group == 1) {
+        Integer A = (Integer){a_abs.chunks + split, a_abs.chunks_size - split};
+        Integer B = (Integer){b_abs.chunks + split, b_abs.chunks_size - split};
+        Integer result_2 = (Integer){product.chunks + split * 2, product.chunks_size - split * 2};
+        _integer_mul_unsigned(scratch, result_2, A, B);
+      } else {
+        _integer_mul_unsigned(scratch, data->result_1, data->result_ApC, data->result_BpD);
+      }
+    }
+    barrier_join_threads(t, threads_start, threads_end);
+  } else if (is_first) {
+    _integer_mul_unsigned(scratch, product, data->a, data->b);
+  }
+  // merge result_1
+  if (is_first) {
+    if (data->is_parallel) {
+      Integer result_0 = (Integer){product.chunks, split * 2};
+      Integer result_2 = (Integer){product.chunks + split * 2, product.chunks_size - split * 2};
+      Integer result_1 = data->result_1;
+      _integer_sub_from_unsigned(result_1, result_0);
+      _integer_sub_from_unsigned(result_1, result_2);
+      result_1.chunks_size = _integer_unsigned_size(result_1);
+      _integer_add_to_unsigned((Integer){product.chunks + split, product.chunks_size - split}, result_1);
+    }
+    // sign
+    if (data->is_negative) {
+      integer_negate(result, data->product);
+    } else {
+      integer_copy(result, data->product);
+    }
+    arena_reset(scratch, mark);
+  }
+  barrier(t);
+}
+
+// squaring
+/* NOTE: squaring schoolbook only needs half the chunk products, so it stays faster for longer */
+#ifndef INTEGER_KARATSUBA_SQUARE_THRESHOLD
+  #define INTEGER_KARATSUBA_SQUARE_THRESHOLD 48
+#endif
+/* NOTE: `result.chunks_size == a.chunks_size * 2`, `result` must not alias `a` */
+void _integer_square_schoolbook_unsigned(Integer result, Integer a) {
+  usize n = a.chunks_size;
+  for (usize i = 0; i < result.chunks_size; i++) {
+    result.chunks[i] = 0;
+  }
+  // a[i] * a[j] for i < j
+  for (usize i = 0; i + 1 < n; i++) {
+    Integer a_rest = (Integer){&a.chunks[i + 1], n - i - 1};
+    Integer result_slice = (Integer){&result.chunks[2 * i + 1], n - i - 1};
+    result.chunks[i + n] = _integer_mul_add_u64_unsigned(result_slice, a_rest, a.chunks[i]);
+  }
+  // double them
+  _integer_shift_left_bits_unsigned(result, result, 1);
+  // a[i] * a[i]
+  u64 carry = 0;
+  for (usize i = 0; i < n; i++) {
+    u128 square = u128(a.chunks[i]) * a.chunks[i];
+    result.chunks[2 * i] = add_with_carry(result.chunks[2 * i], u64(square), carry, &carry);
+    result.chunks[2 * i + 1] = add_with_carry(result.chunks[2 * i + 1], u64(square >> 64), carry, &carry);
+  }
+}
+/* NOTE: `result.chunks_size == a.chunks_size * 2`, `result` must not alias `a` */
+void _integer_karatsuba_square_unsigned(Arena *scratch, Integer result, Integer a) {
+  if (a.chunks_size < INTEGER_KARATSUBA_SQUARE_THRESHOLD) {
+    _integer_square_schoolbook_unsigned(result, a);
+    return;
+  } else if (a.chunks_size >= INTEGER_NTT_THRESHOLD) {
+    /* NOTE: squaring only needs one forward transform */
+    _integer_ntt_mul_unsigned(scratch, result, a, a);
+    return;
+  }
+  /* NOTE: `a^2 = A^2*2^(128*split) + ((A+C)^2 - A^2 - C^2)*2^(64*split) + C^2` */
+  usize split = (a.chunks_size + 1) / 2;
+  Integer A = (Integer){a.chunks + split, a.chunks_size - split};
+  Integer C = (Integer){a.chunks, split};
+  Integer result_0 = (Integer){result.chunks, split * 2};
+  _integer_karatsuba_square_unsigned(scratch, result_0, C);
+  Integer result_2 = (Integer){result.chunks + split * 2, result.chunks_size - split * 2};
+  _integer_karatsuba_square_unsigned(scratch, result_2, A);
+  with_arena(scratch) {
+    Integer result_ApC = integer_arena_alloc(scratch, u64(split) + 1);
+    _integer_copy_unsigned(result_ApC, C);
+    result_ApC.chunks[split] = _integer_add_to_unsigned((Integer){result_ApC.chunks, split}, A);
+    Integer result_1 = integer_arena_alloc(scratch, (u64(split) + 1) * 2);
+    _integer_karatsuba_square_unsigned(scratch, result_1, result_ApC);
+    _integer_sub_from_unsigned(result_1, result_0);
+    _integer_sub_from_unsigned(result_1, result_2);
+    // merge result_1
+    result_1.chunks_size = _integer_unsigned_size(result_1);
+    _integer_add_to_unsigned((Integer){result.chunks + split, result.chunks_size - split}, result_1);
+  }
+}
+#define integer_square_size(a) (a.chunks_size * 2)
+void integer_square(Arena *scratch, Integer *result, Integer a) {
+  bool a_negative = integer_sign_extension(a) != 0;
+  with_arena(scratch) {
+    // abs
+    Integer a_abs = integer_arena_alloc(scratch, integer_negate_size(a));
+    if (a_negative) {
+      integer_negate(&a_abs, a);
+    } else {
+      integer_copy(&a_abs, a);
+    }
+    a_abs.chunks_size = max(_integer_unsigned_size(a_abs), 1);
+    // square
+    /* NOTE: the extra zero chunk keeps this non-negative in two's complement */
+    Integer square = integer_arena_alloc(scratch, a_abs.chunks_size * 2 + 1);
+    square.chunks[square.chunks_size - 1] = 0;
+    _integer_karatsuba_square_unsigned(scratch, (Integer){square.chunks, square.chunks_size - 1}, a_abs);
+    integer_copy(result, square);
+  }
+}
+/* NOTE: `base^exponent < 2^(exponent * bit_length(base))`, plus room for the sign bit */
+#define integer_pow_u64_size(base, exponent) ((exponent) * (64 - count_leading_zeros(u64, base)) / 64 + 1)
+void integer_pow_u64(Arena *scratch, Integer *result, u64 base, u64 exponent) {
+  with_arena(scratch) {
+    /* NOTE: squaring needs twice the chunks of the current value, plus the sign chunk */
+    u64 buffer_size = result->chunks_size * 2 + 1;
+    Integer value = integer_arena_alloc(scratch, buffer_size);
+    Integer square = integer_arena_alloc(scratch, buffer_size);
+    value.chunks[0] = 1;
+    usize size = 1;
+    // exponentiation by squaring, from the top bit
+    u64 bit = exponent == 0 ? 0 : u64(1) << index_first_one_floor(u64, exponent);
+    while (bit != 0) {
+      if (size > 1 || value.chunks[0] != 1) {
+        _integer_karatsuba_square_unsigned(scratch, (Integer){square.chunks, size * 2}, (Integer){value.chunks, size});
+        size = max(_integer_unsigned_size((Integer){square.chunks, size * 2}), 1);
+        Integer tmp = value;
+        value = square;
+        square = tmp;
+      }
+      if (exponent & bit) {
+        u64 carry = _integer_mul_u64_unsigned((Integer){value.chunks, size}, (Integer){value.chunks, size}, base);
+        if (carry != 0) { value.chunks[size++] = carry; }
+      }
+      bit >>= 1;
+    }
+    value.chunks[size] = 0;
+    integer_copy(result, (Integer){value.chunks, size + 1});
+  }
+}
+
+// division
+/* NOTE: Improved division by invariant integers (Möller, Granlund 2011) https://gmplib.org/~tege/division-paper.pdf
+  returns `floor((2^128 - 1) / divisor) - 2^64`, for a normalized `divisor` (top bit set) */
+u64 _u64_reciprocal(u64 divisor) {
+  u64 high = ~divisor;
+  u64 low = MAX_u64;
+#if ARCH_X64
+  /* NOTE: `high < divisor`, so this can't overflow */
+  u64 quotient, remainder;
+  asm("div %[divisor]" : "=a"(quotient), "=d"(remainder) : "a"(low), "d"(high), [divisor] "r"(divisor));
+  return quotient;
+#else
+  /* NOTE: bitwise long division, so we don't depend on `__udivti3()` */
+  u64 quotient = 0;
+  for (usize i = 0; i < 64; i++) {
+    u64 high_bit = high >> 63;
+    high = (high << 1) | (low >> 63);
+    low <<= 1;
+    quotient <<= 1;
+    if (high_bit != 0 || high >= divisor) {
+      high -= divisor;
+      quotient |= 1;
+    }
+  }
+  return quotient;
+#endif
+}
+/* NOTE: divides `(high, low)` by a normalized `divisor`, requires `high < divisor` */
+u64 _u128_div_u64_preinverted(u64 high, u64 low, u64 divisor, u64 reciprocal, u64 *remainder) {
+  u128 q = u128(reciprocal) * high + ((u128(high) << 64) | low);
+  u64 q_high = u64(q >> 64) + 1;
+  u64 q_low = u64(q);
+  u64 r = low - q_high * divisor;
+  if (r > q_low) {
+    q_high--;
+    r += divisor;
+  }
+  if (expect_far(r >= divisor)) {
+    q_high++;
+    r -= divisor;
+  }
+  *remainder = r;
+  return q_high;
+}
+/* NOTE: `quotient = a / divisor`, treating `a` as unsigned, returns the remainder,
+  `quotient` may alias `a` */
+#define integer_div_u64_size(a) (a.chunks_size)
+u64 integer_div_u64(Integer *quotient, Integer a, u64 divisor) {
+  assert(divisor != 0);
+  u64 shift = count_leading_zeros(u64, divisor);
+  u64 normalized_divisor = divisor << shift;
+  u64 reciprocal = _u64_reciprocal(normalized_divisor);
+  usize i = a.chunks_size;
+  u64 remainder = (a.chunks[i - 1] >> 1) >> (63 - shift);
+  while (i > 0) {
+    i--;
+    u64 next_chunk = i > 0 ? a.chunks[i - 1] : 0;
+    u64 chunk = (a.chunks[i] << shift) | ((next_chunk >> 1) >> (63 - shift));
+    u64 q = _u128_div_u64_preinverted(remainder, chunk, normalized_divisor, reciprocal, &remainder);
+    if (i < quotient->chunks_size) { quotient->chunks[i] = q; }
+  }
+  for (i = a.chunks_size; i < quotient->chunks_size; i++) {
+    quotient->chunks[i] = 0;
+  }
+  return remainder >> shift;
+}
+/* NOTE: The Art of Computer Programming, Vol. 2, 4.3.1, Algorithm D (Knuth 1997)
+  `a.chunks_size >= b.chunks_size >= 2`, `b` has no leading zero chunks,
+  `quotient.chunks_size == a.chunks_size - b.chunks_size + 1`, `remainder.chunks_size == b.chunks_size` */
+void _integer_div_unsigned(Arena *scratch, Integer quotient, Integer remainder, Integer a, Integer b) {
+  usize n = b.chunks_size;
+  usize m = a.chunks_size - n;
+  with_arena(scratch) {
+    // normalize
+    u64 shift = count_leading_zeros(u64, b.chunks[n - 1]);
+    Integer u = integer_arena_alloc(scratch, a.chunks_size + 1);
+    Integer v = integer_arena_alloc(scratch, n);
+    u.chunks[a.chunks_size] = _integer_shift_left_bits_unsigned((Integer){u.chunks, a.chunks_size}, a, shift);
+    _integer_shift_left_bits_unsigned(v, b, shift);
+    u64 v_top = v.chunks[n - 1];
+    u64 v_next = v.chunks[n - 2];
+    u64 reciprocal = _u64_reciprocal(v_top);
+    // divide
+    usize j = m + 1;
+    do {
+      j--;
+      u64 u_2 = u.chunks[j + n];
+      u64 u_1 = u.chunks[j + n - 1];
+      u64 u_0 = u.chunks[j + n - 2];
+      // estimate the quotient chunk from the top 2 chunks
+      u64 q_hat, r_hat;
+      bool r_hat_overflow;
+      if (expect_far(u_2 >= v_top)) {
+        q_hat = MAX_u64;
+        r_hat_overflow = add_overflow(u_1, v_top, &r_hat);
+      } else {
+        q_hat = _u128_div_u64_preinverted(u_2, u_1, v_top, reciprocal, &r_hat);
+        r_hat_overflow = false;
+      }
+      // refine it using the 3rd chunk, so it's off by at most 1
+      while (!r_hat_overflow && u128(q_hat) * v_next > ((u128(r_hat) << 64) | u_0)) {
+        q_hat--;
+        r_hat_overflow = add_overflow(r_hat, v_top, &r_hat);
+      }
+      // multiply and subtract
+      Integer u_slice = (Integer){&u.chunks[j], n};
+      u64 borrow = _integer_mul_sub_u64_unsigned(u_slice, v, q_hat);
+      if (expect_far(sub_overflow(u_2, borrow, &u.chunks[j + n]))) {
+        // add back
+        q_hat--;
+        u.chunks[j + n] += _integer_add_to_unsigned(u_slice, v);
+      }
+      quotient.chunks[j] = q_hat;
+    } while (j > 0);
+    // unnormalize
+    _integer_shift_right_bits_unsigned(remainder, (Integer){u.chunks, n}, shift);
+  }
+}
+/* NOTE: truncating division like in C, so `a = quotient * b + remainder`, and `remainder` has the sign of `a` */
+#define integer_div_quotient_size(a, b)  (a.chunks_size + 1)
+#define integer_div_remainder_size(a, b) (b.chunks_size)
+void integer_div(Arena *scratch, Integer *quotient, Integer *remainder, Integer a, Integer b) {
+  bool a_negative = integer_sign_extension(a) != 0;
+  bool b_negative = integer_sign_extension(b) != 0;
+  with_arena(scratch) {
+    // abs
+    Integer a_abs = integer_arena_alloc(scratch, integer_negate_size(a));
+    if (a_negative) {
+      integer_negate(&a_abs, a);
+    } else {
+      integer_copy(&a_abs, a);
+    }
+    Integer b_abs = integer_arena_alloc(scratch, integer_negate_size(b));
+    if (b_negative) {
+      integer_negate(&b_abs, b);
+    } else {
+      integer_copy(&b_abs, b);
+    }
+    usize a_size = _integer_unsigned_size(a_abs);
+    usize b_size = _integer_unsigned_size(b_abs);
+    assert(b_size > 0);
+    // divide
+    /* NOTE: the extra zero chunk keeps these non-negative in two's complement */
+    Integer q = integer_arena_alloc(scratch, a_abs.chunks_size);
+    Integer r = integer_arena_alloc(scratch, b_abs.chunks_size);
+    for (usize i = 0; i < q.chunks_size; i++) { q.chunks[i] = 0; }
+    for (usize i = 0; i < r.chunks_size; i++) { r.chunks[i] = 0; }
+    if (a_size < b_size) {
+      integer_copy(&r, a_abs);
+    } else if (b_size == 1) {
+      Integer q_slice = (Integer){q.chunks, a_size};
+      r.chunks[0] = integer_div_u64(&q_slice, (Integer){a_abs.chunks, a_size}, b_abs.chunks[0]);
+    } else {
+      Integer q_slice = (Integer){q.chunks, a_size - b_size + 1};
+      Integer r_slice = (Integer){r.chunks, b_size};
+      _integer_div_unsigned(scratch, q_slice, r_slice, (Integer){a_abs.chunks, a_size}, (Integer){b_abs.chunks, b_size});
+    }
+    // sign
+    if (a_negative != b_negative) {
+      integer_negate(quotient, q);
+    } else {
+      integer_copy(quotient, q);
+    }
+    if (a_negative) {
+      integer_negate(remainder, r);
+    } else {
+      integer_copy(remainder, r);
+    }
+  }
+}
+/* NOTE: below this many chunks, compute reciprocals with long division */
+#ifndef INTEGER_RECIPROCAL_THRESHOLD
+  #define INTEGER_RECIPROCAL_THRESHOLD 16
+#endif
+/* NOTE: `result = floor(2^(128 * b.chunks_size) / b)`, so we can divide by `b` with multiplications,
+  `b` has no leading zero chunks, `result.chunks_size == b.chunks_size + 2` */
+void _integer_reciprocal_unsigned(Arena *scratch, Integer result, Integer b) {
+  usize n = b.chunks_size;
+  u64 one = 1;
+  with_arena(scratch) {
+    if (n < INTEGER_RECIPROCAL_THRESHOLD) {
+      // long division
+      Integer power = integer_arena_alloc(scratch, 2 * n + 1);
+      for (usize i = 0; i < 2 * n; i++) { power.chunks[i] = 0; }
+      power.chunks[2 * n] = 1;
+      if (n == 1) {
+        integer_div_u64(&result, power, b.chunks[0]);
+      } else {
+        Integer remainder = integer_arena_alloc(scratch, n);
+        _integer_div_unsigned(scratch, result, remainder, power, b);
+      }
+    } else {
+      /* NOTE: Newton's method, from the reciprocal `y` of the top `h` chunks of `b`:
+        `x = (y - 2^128) * 2^(64 * (n - h))` is an underestimate with about `h - 2` correct chunks,
+        and `x + x * (2^(128 * n) - b * x) / 2^(128 * n)` is still an underestimate, with almost double that */
+      usize h = n / 2 + 3;
+      Integer y = integer_arena_alloc(scratch, h + 2);
+      _integer_reciprocal_unsigned(scratch, y, (Integer){b.chunks + n - h, h});
+      usize i = 2;
+      while (sub_overflow(y.chunks[i], 1, &y.chunks[i])) { i++; }
+      y.chunks_size = _integer_unsigned_size(y);
+      // e = 2^(64 * (n + h)) - b * y
+      Integer e = integer_arena_alloc(scratch, n + h + 2);
+      _integer_mul_unsigned(scratch, (Integer){e.chunks, n + y.chunks_size}, b, y);
+      for (usize j = n + y.chunks_size; j < e.chunks_size; j++) { e.chunks[j] = 0; }
+      e.chunks_size = n + h + 1;
+      integer_negate(&e, e);
+      e.chunks[n + h] += 1;
+      e.chunks_size = max(_integer_unsigned_size(e), 1);
+      // x = y * 2^(64 * (n - h)) + y * e / 2^(128 * h)
+      Integer ye = integer_arena_alloc(scratch, y.chunks_size + e.chunks_size);
+      _integer_mul_unsigned(scratch, ye, y, e);
+      ye.chunks_size = _integer_unsigned_size(ye);
+      if (ye.chunks_size > 2 * h) {
+        _integer_copy_unsigned(result, (Integer){ye.chunks + 2 * h, ye.chunks_size - 2 * h});
+      } else {
+        _integer_copy_unsigned(result, (Integer){ye.chunks, 0});
+      }
+      _integer_add_to_unsigned((Integer){result.chunks + n - h, result.chunks_size - (n - h)}, y);
+      // fix the last few units
+      Integer r = integer_arena_alloc(scratch, n + result.chunks_size);
+      _integer_mul_unsigned(scratch, r, b, result);
+      r.chunks_size = 2 * n + 1;
+      integer_negate(&r, r);
+      r.chunks[2 * n] += 1;
+      while (_integer_compare_unsigned(r, b) >= 0) {
+        _integer_sub_from_unsigned(r, b);
+        _integer_add_to_unsigned(result, (Integer){&one, 1});
+      }
+    }
+  }
+}
+/* NOTE: Barrett reduction (Handbook of Applied Cryptography, 14.42), `a < 2^(128 * b.chunks_size)`,
+  `b` has no leading zero chunks, `reciprocal == floor(2^(128 * b.chunks_size) / b)`,
+  `quotient.chunks_size == a.chunks_size - b.chunks_size + 1`, `remainder.chunks_size == b.chunks_size` */
+void _integer_div_preinverted_unsigned(Arena *scratch, Integer quotient, Integer remainder, Integer a, Integer b, Integer reciprocal) {
+  usize n = b.chunks_size;
+  u64 one = 1;
+  with_arena(scratch) {
+    // estimate the quotient, it's off by at most 2
+    Integer a_high = (Integer){a.chunks + n - 1, a.chunks_size - n + 1};
+    Integer q = integer_arena_alloc(scratch, a_high.chunks_size + reciprocal.chunks_size);
+    _integer_mul_unsigned(scratch, q, a_high, reciprocal);
+    q = (Integer){q.chunks + n + 1, q.chunks_size - n - 1};
+    q.chunks_size = _integer_unsigned_size(q);
+    _integer_copy_unsigned(quotient, q);
+    // r = a - q * b
+    Integer r = integer_arena_alloc(scratch, a.chunks_size);
+    _integer_copy_unsigned(r, a);
+    if (q.chunks_size > 0) {
+      Integer qb = integer_arena_alloc(scratch, q.chunks_size + n);
+      _integer_mul_unsigned(scratch, qb, q, b);
+      qb.chunks_size = _integer_unsigned_size(qb);
+      _integer_sub_from_unsigned(r, qb);
+    }
+    while (_integer_compare_unsigned(r, b) >= 0) {
+      _integer_sub_from_unsigned(r, b);
+      _integer_add_to_unsigned(quotient, (Integer){&one, 1});
+    }
+    _integer_copy_unsigned(remainder, (Integer){r.chunks, _integer_unsigned_size(r)});
+  }
+}
+
+// cached powers
+/* NOTE: `5^exponent` and `10^exponent` are built once, and then shared by all threads */
+#ifndef INTEGER_POW_CACHE_SIZE
+  #define INTEGER_POW_CACHE_SIZE 4096
+#endif
+ASSERT_POWER_OF_TWO(INTEGER_POW_CACHE_SIZE);
+STRUCT(IntegerPowCacheEntry) {
+  /* NOTE: `exponent + 1`, or 0 if the entry is empty */
+  u64 key;
+  u32 ready;
+  Integer value;
+};
+STRUCT(IntegerPowCache) {
+  IntegerPowCacheEntry entries[INTEGER_POW_CACHE_SIZE];
+};
+global IntegerPowCache global_pow5_cache;
+global IntegerPowCache global_pow10_cache;
+forward_declare void wake_all_on_address(u32 *address);
+/* NOTE: returns the entry for `exponent`, and whether we claimed it and must fill it in */
+IntegerPowCacheEntry *_integer_pow_cache_find(IntegerPowCache *cache, u64 exponent, bool *is_owner) {
+  u64 key = exponent + 1;
+  u64 hash = (key * 0x9E3779B97F4A7C15) >> 32;
+  for (usize i = 0; i < INTEGER_POW_CACHE_SIZE; i++) {
+    IntegerPowCacheEntry *entry = &cache->entries[(hash + i) & (INTEGER_POW_CACHE_SIZE - 1)];
+    u64 entry_key = atomic_load(&entry->key);
+    if (entry_key == 0 && atomic_compare_exchange(&entry->key, &entry_key, key)) {
+      *is_owner = true;
+      return entry;
+    }
+    if (entry_key == key) {
+      *is_owner = false;
+      return entry;
+    }
+  }
+  assert2(false, string("IntegerPowCache is full"));
+  return nil;
+}
+/* NOTE: fills in an entry we own, and wakes up the threads waiting on it */
+void _integer_pow_cache_store(IntegerPowCacheEntry *entry, Integer value) {
+  /* NOTE: keep one zero chunk, so it's non-negative in two's complement */
+  usize size = _integer_unsigned_size(value);
+  Integer stored = (Integer){alloc_array(u64, size + 1), size + 1};
+  _integer_copy_unsigned(stored, (Integer){value.chunks, size});
+  entry->value = stored;
+  atomic_store(&entry->ready, 1);
+  wake_all_on_address(&entry->ready);
+}
+/* NOTE: `5^exponent = (5^(exponent / 2))^2 * 5^(exponent % 2)`, so each power reuses the smaller cached ones */
+Integer integer_pow5_cached(Arena *scratch, u64 exponent) {
+  bool is_owner;
+  IntegerPowCacheEntry *entry = _integer_pow_cache_find(&global_pow5_cache, exponent, &is_owner);
+  if (is_owner) {
+    with_arena(scratch) {
+      Integer value;
+      if (exponent < 28) {
+        /* NOTE: `5^27 < 2^64` */
+        value = integer_arena_alloc(scratch, 2);
+        value.chunks[0] = 1;
+        for (u64 i = 0; i < exponent; i++) {
+          value.chunks[0] *= 5;
+        }
+        value.chunks[1] = 0;
+      } else {
+        Integer half = integer_pow5_cached(scratch, exponent / 2);
+        half.chunks_size = _integer_unsigned_size(half);
+        value = integer_arena_alloc(scratch, half.chunks_size * 2 + 1);
+        _integer_karatsuba_square_unsigned(scratch, (Integer){value.chunks, half.chunks_size * 2}, half);
+        value.chunks[half.chunks_size * 2] = 0;
+        if (exponent % 2 != 0) {
+          value.chunks[half.chunks_size * 2] = _integer_mul_u64_unsigned(value, (Integer){value.chunks, half.chunks_size * 2}, 5);
+        }
+      }
+      _integer_pow_cache_store(entry, value);
+    }
+  } else {
+    wait_on_address(&entry->ready, 0);
+  }
+  return entry->value;
+}
+/* NOTE: `10^exponent = 5^exponent * 2^exponent` */
+Integer integer_pow10_cached(Arena *scratch, u64 exponent) {
+  bool is_owner;
+  IntegerPowCacheEntry *entry = _integer_pow_cache_find(&global_pow10_cache, exponent, &is_owner);
+  if (is_owner) {
+    Integer pow5 = integer_pow5_cached(scratch, exponent);
+    with_arena(scratch) {
+      Integer value = integer_arena_alloc(scratch, pow5.chunks_size + exponent / 64 + 1);
+      integer_shift_left(&value, pow5, exponent);
+      _integer_pow_cache_store(entry, value);
+    }
+  } else {
+    wait_on_address(&entry->ready, 0);
+  }
+  return entry->value;
+}
+
+// decimal parsing
+#define INTEGER_DIGITS_PER_CHUNK 19
+#define INTEGER_10_POW_19        u64(10000000000000000000)
+/* NOTE: below this many chunks, parse one 19 digit chunk at a time, since `* 10^19` is a single multiply per chunk */
+#ifndef INTEGER_PARSE_DECIMAL_THRESHOLD
+  #define INTEGER_PARSE_DECIMAL_THRESHOLD 512
+#endif
+/* NOTE: returns `10^(19 * 2^k)` from the cache, without the sign chunk */
+Integer _integer_decimal_power(Arena *scratch, usize k) {
+  Integer power = integer_pow10_cached(scratch, u64(INTEGER_DIGITS_PER_CHUNK) << k);
+  power.chunks_size = _integer_unsigned_size(power);
+  return power;
+}
+/* NOTE: `10^digits_size < 2^(64 * chunks)`, since `log2(10^19) < 64` */
+#define _integer_decimal_chunks(digits_size) ((digits_size) / INTEGER_DIGITS_PER_CHUNK + 1)
+u64 _integer_parse_u64_decimal(string digits) {
+  u64 value = 0;
+  for (usize i = 0; i < digits.size; i++) {
+    value = value * 10 + u64(digits.ptr[i] - '0');
+  }
+  return value;
+}
+/* NOTE: `result.chunks_size >= _integer_decimal_chunks(digits.size)`, returns the used size */
+usize _integer_parse_decimal_schoolbook_unsigned(Integer result, string digits) {
+  usize size = 0;
+  usize start = 0;
+  usize end = digits.size % INTEGER_DIGITS_PER_CHUNK;
+  if (end == 0) { end = min(digits.size, INTEGER_DIGITS_PER_CHUNK); }
+  while (start < digits.size) {
+    // result = result * 10^19 + chunk
+    u64 carry = _integer_parse_u64_decimal(str_slice(digits, start, end));
+    for (usize i = 0; i < size; i++) {
+      u128 product = u128(result.chunks[i]) * INTEGER_10_POW_19 + carry;
+      result.chunks[i] = u64(product);
+      carry = u64(product >> 64);
+    }
+    if (carry != 0) { result.chunks[size++] = carry; }
+    start = end;
+    end += INTEGER_DIGITS_PER_CHUNK;
+  }
+  for (usize i = size; i < result.chunks_size; i++) {
+    result.chunks[i] = 0;
+  }
+  return size;
+}
+/* NOTE: `result.chunks_size >= _integer_decimal_chunks(digits.size)`, `powers[k] == 10^(19 * 2^k)`, returns the used size */
+usize _integer_parse_decimal_unsigned(Arena *scratch, Integer result, string digits, Integer *powers) {
+  usize chunks = (digits.size + INTEGER_DIGITS_PER_CHUNK - 1) / INTEGER_DIGITS_PER_CHUNK;
+  if (chunks < INTEGER_PARSE_DECIMAL_THRESHOLD) {
+    return _integer_parse_decimal_schoolbook_unsigned(result, digits);
+  }
+  /* NOTE: `digits = high * 10^(19 * 2^k) + low`, where `2^k < chunks <= 2^(k+1)` */
+  usize k = index_first_one_floor(u64, chunks - 1);
+  usize high_size = digits.size - (usize(INTEGER_DIGITS_PER_CHUNK) << k);
+  string high = str_slice(digits, 0, high_size);
+  string low = str_slice(digits, high_size, digits.size);
+  Integer power = powers[k];
+  _integer_parse_decimal_unsigned(scratch, result, low, powers);
+  with_arena(scratch) {
+    Integer high_value = integer_arena_alloc(scratch, _integer_decimal_chunks(high.size));
+    high_value.chunks_size = max(_integer_parse_decimal_unsigned(scratch, high_value, high, powers), 1);
+    Integer product = integer_arena_alloc(scratch, high_value.chunks_size + power.chunks_size);
+    _integer_mul_unsigned(scratch, product, high_value, power);
+    product.chunks_size = _integer_unsigned_size(product);
+    _integer_add_to_unsigned(result, product);
+  }
+  return _integer_unsigned_size(result);
+}
+/* NOTE: `digits` is an optional '-' followed by '0'-'9', like integer_sprint_decimal() writes */
+#define integer_parse_decimal_size(digits) (_integer_decimal_chunks(digits.size) + 1)
+void integer_parse_decimal(Arena *scratch, Integer *result, string digits) {
+  bool is_negative = digits.size > 0 && digits.ptr[0] == '-';
+  if (is_negative) { digits = str_slice(digits, 1, digits.size); }
+  usize chunks = (digits.size + INTEGER_DIGITS_PER_CHUNK - 1) / INTEGER_DIGITS_PER_CHUNK;
+  with_arena(scratch) {
+    // powers of 10
+    usize powers_size = (chunks > 1 ? index_first_one_floor(u64, chunks - 1) : 0) + 1;
+    Integer *powers = arena_alloc_array(scratch, Integer, powers_size);
+    for (usize k = 0; k < powers_size; k++) {
+      powers[k] = _integer_decimal_power(scratch, k);
+    }
+    // parse
+    /* NOTE: the extra zero chunk keeps this non-negative in two's complement */
+    Integer value = integer_arena_alloc(scratch, _integer_decimal_chunks(digits.size) + 1);
+    value.chunks[value.chunks_size - 1] = 0;
+    _integer_parse_decimal_unsigned(scratch, (Integer){value.chunks, value.chunks_size - 1}, digits, powers);
+    // sign
+    if (is_negative) {
+      integer_negate(result, value);
+    } else {
+      integer_copy(result, value);
+    }
+  }
+}
+
+// decimal formatting
+/* NOTE: below this many chunks, peel off one 19 digit chunk at a time with `integer_div_u64()` */
+#ifndef INTEGER_SPRINT_DECIMAL_THRESHOLD
+  #define INTEGER_SPRINT_DECIMAL_THRESHOLD 128
+#endif
+/* NOTE: writes `a` backwards from `buffer_end`, zero padded to `min_digits`, clobbers `a`, returns the size */
+usize _integer_sprint_decimal_schoolbook_unsigned(Integer a, byte *buffer_end, usize min_digits) {
+  usize size = 0;
+  a.chunks_size = _integer_unsigned_size(a);
+  while (a.chunks_size > 0) {
+    u64 chunk = integer_div_u64(&a, a, INTEGER_10_POW_19);
+    a.chunks_size = _integer_unsigned_size(a);
+    size += sprint_u64(chunk, buffer_end - size);
+    if (a.chunks_size > 0) {
+      while (size % INTEGER_DIGITS_PER_CHUNK != 0) {
+        *(buffer_end - ++size) = '0';
+      }
+    }
+  }
+  while (size < min_digits) {
+    *(buffer_end - ++size) = '0';
+  }
+  return size;
+}
+/* NOTE: `powers[k] == 10^(19 * 2^k)`, `reciprocals[k] == floor(2^(128 * powers[k].chunks_size) / powers[k])` */
+usize _integer_sprint_decimal_unsigned(Arena *scratch, Integer a, byte *buffer_end, usize min_digits, Integer *powers, Integer *reciprocals, usize powers_size) {
+  a.chunks_size = _integer_unsigned_size(a);
+  if (a.chunks_size < INTEGER_SPRINT_DECIMAL_THRESHOLD) {
+    return _integer_sprint_decimal_schoolbook_unsigned(a, buffer_end, min_digits);
+  }
+  /* NOTE: `a = high * 10^(19 * 2^k) + low`, where `power.chunks_size < a.chunks_size <= 2 * power.chunks_size`,
+    so `high > 0`, and `a < 2^(128 * power.chunks_size)` like Barrett reduction wants */
+  usize k = 0;
+  while (k + 1 < powers_size && powers[k + 1].chunks_size < a.chunks_size) {
+    k++;
+  }
+  Integer power = powers[k];
+  usize size;
+  with_arena(scratch) {
+    Integer high = integer_arena_alloc(scratch, a.chunks_size - power.chunks_size + 1);
+    Integer low = integer_arena_alloc(scratch, power.chunks_size);
+    _integer_div_preinverted_unsigned(scratch, high, low, a, power, reciprocals[k]);
+    size = _integer_sprint_decimal_unsigned(scratch, low, buffer_end, usize(INTEGER_DIGITS_PER_CHUNK) << k, powers, reciprocals, powers_size);
+    usize high_min_digits = min_digits > size ? min_digits - size : 0;
+    size += _integer_sprint_decimal_unsigned(scratch, high, buffer_end - size, high_min_digits, powers, reciprocals, powers_size);
+  }
+  return size;
+}
+/* NOTE: `64 * log10(2) < 20` digits per chunk, plus the sign */
+#define integer_sprint_decimal_size(a) (a.chunks_size * 20 + 1)
+/* NOTE: writes `a` backwards from `buffer_end` like `sprint_i64()`, returns the size */
+usize integer_sprint_decimal(Arena *scratch, Integer a, byte *buffer_end) {
+  bool a_negative = integer_sign_extension(a) != 0;
+  usize size;
+  with_arena(scratch) {
+    // abs
+    Integer a_abs = integer_arena_alloc(scratch, integer_negate_size(a));
+    if (a_negative) {
+      integer_negate(&a_abs, a);
+    } else {
+      integer_copy(&a_abs, a);
+    }
+    a_abs.chunks_size = _integer_unsigned_size(a_abs);
+    // powers of 10 and their reciprocals
+    Integer *powers = arena_alloc_array(scratch, Integer, 64);
+    Integer *reciprocals = arena_alloc_array(scratch, Integer, 64);
+    powers[0] = _integer_decimal_power(scratch, 0);
+    usize powers_size = 1;
+    if (a_abs.chunks_size >= INTEGER_SPRINT_DECIMAL_THRESHOLD) {
+      /* NOTE: `(10^(19 * 2^k))^2` has at least `2 * powers[k].chunks_size - 1` chunks */
+      while (2 * powers[powers_size - 1].chunks_size - 1 < a_abs.chunks_size) {
+        powers[powers_size] = _integer_decimal_power(scratch, powers_size);
+        powers_size++;
+      }
+      /* NOTE: only the powers we split by need a reciprocal */
+      for (usize k = 0; k < powers_size; k++) {
+        Integer power = powers[k];
+        if (2 * power.chunks_size >= INTEGER_SPRINT_DECIMAL_THRESHOLD && power.chunks_size < a_abs.chunks_size) {
+          reciprocals[k] = integer_arena_alloc(scratch, power.chunks_size + 2);
+          _integer_reciprocal_unsigned(scratch, reciprocals[k], power);
+        }
+      }
+    }
+    // format
+    size = _integer_sprint_decimal_unsigned(scratch, a_abs, buffer_end, 1, powers, reciprocals, powers_size);
+    if (a_negative) {
+      *(buffer_end - ++size) = '-';
+    }
+  }
+  return size;
+}
+
+// gcd
+usize _integer_bit_length_unsigned(Integer a) {
+  usize size = _integer_unsigned_size(a);
+  return size == 0 ? 0 : size * 64 - count_leading_zeros(u64, a.chunks[size - 1]);
+}
+usize _integer_trailing_zeros_unsigned(Integer a) {
+  usize i = 0;
+  while (i < a.chunks_size && a.chunks[i] == 0) {
+    i++;
+  }
+  return i < a.chunks_size ? i * 64 + count_trailing_zeros(u64, a.chunks[i]) : 0;
+}
+/* NOTE: binary GCD (Stein 1967), `result.chunks_size >= max(a.chunks_size, b.chunks_size)` */
+void _integer_gcd_unsigned(Arena *scratch, Integer result, Integer a, Integer b) {
+  with_arena(scratch) {
+    /* NOTE: the extra zero chunk keeps these non-negative for the shifts */
+    Integer u = integer_arena_alloc(scratch, a.chunks_size + 1);
+    Integer v = integer_arena_alloc(scratch, b.chunks_size + 1);
+    _integer_copy_unsigned(u, a);
+    _integer_copy_unsigned(v, b);
+    if (_integer_unsigned_size(u) == 0) {
+      _integer_copy_unsigned(result, (Integer){v.chunks, _integer_unsigned_size(v)});
+    } else if (_integer_unsigned_size(v) == 0) {
+      _integer_copy_unsigned(result, (Integer){u.chunks, _integer_unsigned_size(u)});
+    } else {
+      // gcd(2^i * u, 2^j * v) = 2^min(i, j) * gcd(u, v)
+      usize u_zeros = _integer_trailing_zeros_unsigned(u);
+      usize v_zeros = _integer_trailing_zeros_unsigned(v);
+      integer_shift_right(&u, u, u_zeros, false);
+      integer_shift_right(&v, v, v_zeros, false);
+      // gcd(u, v) = gcd(u - v, v), and `u - v` is even
+      while (true) {
+        i32 comparison = _integer_compare_unsigned(u, v);
+        if (comparison == 0) { break; }
+        if (comparison < 0) {
+          Integer tmp = u;
+          u = v;
+          v = tmp;
+        }
+        _integer_sub_from_unsigned(u, (Integer){v.chunks, _integer_unsigned_size(v)});
+        integer_shift_right(&u, u, _integer_trailing_zeros_unsigned(u), false);
+      }
+      integer_shift_left(&u, u, min(u_zeros, v_zeros));
+      _integer_copy_unsigned(result, (Integer){u.chunks, _integer_unsigned_size(u)});
+    }
+  }
 }
 
 // Rational
+/* NOTE: `a / b`, normalized means that `b > 0` and `gcd(a, b) == 1` */
 STRUCT(Rational) {
   Integer *a;
   Integer *b;
 };
+void rational_normalize(Arena *scratch, Rational x) {
+  bool b_negative = integer_sign_extension((*x.b)) != 0;
+  with_arena(scratch) {
+    // abs
+    Integer a_abs = integer_arena_alloc(scratch, integer_negate_size((*x.a)));
+    if (integer_sign_extension((*x.a)) != 0) {
+      integer_negate(&a_abs, *x.a);
+    } else {
+      integer_copy(&a_abs, *x.a);
+    }
+    Integer b_abs = integer_arena_alloc(scratch, integer_negate_size((*x.b)));
+    if (b_negative) {
+      integer_negate(&b_abs, *x.b);
+    } else {
+      integer_copy(&b_abs, *x.b);
+    }
+    assert(_integer_unsigned_size(b_abs) > 0);
+    // divide by the gcd
+    /* NOTE: the extra zero chunk keeps this non-negative in two's complement */
+    Integer gcd = integer_arena_alloc(scratch, max(a_abs.chunks_size, b_abs.chunks_size) + 1);
+    _integer_gcd_unsigned(scratch, (Integer){gcd.chunks, gcd.chunks_size - 1}, a_abs, b_abs);
+    gcd.chunks[gcd.chunks_size - 1] = 0;
+    Integer remainder = integer_arena_alloc(scratch, integer_div_remainder_size(a_abs, gcd));
+    integer_div(scratch, x.a, &remainder, *x.a, gcd);
+    integer_div(scratch, x.b, &remainder, *x.b, gcd);
+    // sign
+    if (b_negative) {
+      integer_negate(x.a, *x.a);
+      integer_negate(x.b, *x.b);
+    }
+  }
+}
+/* NOTE: `result` may alias `x` or `y` */
+#define rational_add_size_a(x, y) (max(x.a->chunks_size + y.b->chunks_size, y.a->chunks_size + x.b->chunks_size) + 1)
+#define rational_add_size_b(x, y) (x.b->chunks_size + y.b->chunks_size)
+void rational_add(Arena *scratch, Rational result, Rational x, Rational y) {
+  with_arena(scratch) {
+    Integer a_0 = integer_arena_alloc(scratch, x.a->chunks_size + y.b->chunks_size);
+    Integer a_1 = integer_arena_alloc(scratch, y.a->chunks_size + x.b->chunks_size);
+    Integer b = integer_arena_alloc(scratch, rational_add_size_b(x, y));
+    integer_mul(scratch, &a_0, *x.a, *y.b);
+    integer_mul(scratch, &a_1, *y.a, *x.b);
+    integer_mul(scratch, &b, *x.b, *y.b);
+    integer_add(result.a, a_0, a_1);
+    integer_copy(result.b, b);
+  }
+  rational_normalize(scratch, result);
+}
+/* NOTE: `result` may alias `x` or `y` */
+#define rational_mul_size_a(x, y) (x.a->chunks_size + y.a->chunks_size)
+#define rational_mul_size_b(x, y) (x.b->chunks_size + y.b->chunks_size)
+void rational_mul(Arena *scratch, Rational result, Rational x, Rational y) {
+  with_arena(scratch) {
+    Integer a = integer_arena_alloc(scratch, rational_mul_size_a(x, y));
+    Integer b = integer_arena_alloc(scratch, rational_mul_size_b(x, y));
+    integer_mul(scratch, &a, *x.a, *y.a);
+    integer_mul(scratch, &b, *x.b, *y.b);
+    integer_copy(result.a, a);
+    integer_copy(result.b, b);
+  }
+  rational_normalize(scratch, result);
+}
+/* NOTE: returns -1, 0 or 1, requires `x.b > 0` and `y.b > 0` */
+i32 rational_compare(Arena *scratch, Rational x, Rational y) {
+  i32 comparison;
+  with_arena(scratch) {
+    // x.a * y.b - y.a * x.b
+    Integer a_0 = integer_arena_alloc(scratch, x.a->chunks_size + y.b->chunks_size);
+    Integer a_1 = integer_arena_alloc(scratch, y.a->chunks_size + x.b->chunks_size);
+    integer_mul(scratch, &a_0, *x.a, *y.b);
+    integer_mul(scratch, &a_1, *y.a, *x.b);
+    Integer difference = integer_arena_alloc(scratch, integer_sub_size(a_0, a_1));
+    integer_sub(&difference, a_0, a_1);
+    if (integer_sign_extension(difference) != 0) {
+      comparison = -1;
+    } else {
+      comparison = _integer_unsigned_size(difference) != 0 ? 1 : 0;
+    }
+  }
+  return comparison;
+}
+/* NOTE: correctly rounded (ties to even) with a single division `floor(a * 2^s / b)` */
+f64 rational_to_f64(Arena *scratch, Rational x) {
+  u64 bits;
+  with_arena(scratch) {
+    // abs
+    bool a_negative = integer_sign_extension((*x.a)) != 0;
+    bool b_negative = integer_sign_extension((*x.b)) != 0;
+    Integer a_abs = integer_arena_alloc(scratch, integer_negate_size((*x.a)));
+    if (a_negative) {
+      integer_negate(&a_abs, *x.a);
+    } else {
+      integer_copy(&a_abs, *x.a);
+    }
+    Integer b_abs = integer_arena_alloc(scratch, integer_negate_size((*x.b)));
+    if (b_negative) {
+      integer_negate(&b_abs, *x.b);
+    } else {
+      integer_copy(&b_abs, *x.b);
+    }
+    isize a_bits = isize(_integer_bit_length_unsigned(a_abs));
+    isize b_bits = isize(_integer_bit_length_unsigned(b_abs));
+    assert(b_bits > 0);
+    /* NOTE: `2^(a_bits - b_bits - 1) < a / b < 2^(a_bits - b_bits + 1)` */
+    if (a_bits == 0 || a_bits - b_bits < -1080) {
+      bits = 0;
+    } else if (a_bits - b_bits > 1025) {
+      bits = 0x7FF0000000000000;
+    } else {
+      // q = floor(a * 2^s / b), with 56 or 57 bits
+      isize s = 56 - (a_bits - b_bits);
+      usize a_shift = usize(max(s, 0));
+      usize b_shift = usize(max(-s, 0));
+      Integer numerator = integer_arena_alloc(scratch, a_abs.chunks_size + a_shift / 64 + 1);
+      Integer denominator = integer_arena_alloc(scratch, b_abs.chunks_size + b_shift / 64 + 1);
+      integer_shift_left(&numerator, a_abs, a_shift);
+      integer_shift_left(&denominator, b_abs, b_shift);
+      numerator.chunks_size = _integer_unsigned_size(numerator);
+      denominator.chunks_size = _integer_unsigned_size(denominator);
+      u64 q;
+      bool sticky;
+      if (denominator.chunks_size == 1) {
+        sticky = integer_div_u64(&numerator, numerator, denominator.chunks[0]) != 0;
+        q = numerator.chunks[0];
+      } else {
+        Integer quotient = integer_arena_alloc(scratch, numerator.chunks_size - denominator.chunks_size + 1);
+        Integer remainder = integer_arena_alloc(scratch, denominator.chunks_size);
+        _integer_div_unsigned(scratch, quotient, remainder, numerator, denominator);
+        sticky = _integer_unsigned_size(remainder) != 0;
+        q = quotient.chunks[0];
+      }
+      // round `q * 2^-s` to `m * 2^(exponent - 52)`
+      isize q_bits = 64 - isize(count_leading_zeros(u64, q));
+      isize exponent = max(q_bits - 1 - s, -1022);
+      isize shift = s + exponent - 52;
+      u64 m = q >> shift;
+      u64 rest = q & ((u64(1) << shift) - 1);
+      u64 half = u64(1) << (shift - 1);
+      if (rest > half || (rest == half && (sticky || (m & 1) != 0))) {
+        m++;
+      }
+      /* NOTE: subnormals have `m < 2^52`, and rounding up into the next exponent carries into it */
+      bits = (u64(exponent + 1022) << 52) + m;
+      if (bits >= 0x7FF0000000000000) { bits = 0x7FF0000000000000; }
+    }
+    if (a_negative != b_negative) { bits |= u64(1) << 63; }
+  }
+  return bitcast(bits, u64, f64);
+}
@@ -102,16 +102,46 @@ Bytes page_reserve(usize size) {
 #endif
   return buffer;
 }
-void page_free(uptr ptr) {
+void page_free(Bytes buffer) {
 #if OS_WINDOWS
-  assert(VirtualFree(ptr, 0, MEM_RELEASE));
+  assert(VirtualFree(uptr(buffer.ptr), 0, MEM_RELEASE));
 #elif OS_LINUX
-  assert(munmap(ptr, 0) == 0);
+  /* NOTE: munmap() needs the size, unlike VirtualFree() */
+  assert(munmap(uptr(buffer.ptr), buffer.size) == 0);
 #else
   assert(false);
 #endif
 }
 
+// arena
+/* NOTE: bump allocator for temporaries, reserves the pages up front and commits them on use */
+STRUCT(Arena) {
+  byte *buffer_start;
+  byte *buffer_next;
+  byte *buffer_end;
+};
+Arena arena_init(usize size) {
+  Bytes buffer = page_reserve(size);
+  return (Arena){buffer.ptr, buffer.ptr, buffer.ptr + size};
+}
+void arena_free(Arena *arena) {
+  page_free((Bytes){arena->buffer_start, usize(arena->buffer_end - arena->buffer_start)});
+  *arena = (Arena){};
+}
+rawptr arena_alloc_size(Arena *arena, usize size, usize align_mask) {
+  uptr ptr = align_up(uptr(arena->buffer_next), align_mask);
+  assert2(ptr + size <= uptr(arena->buffer_end), string("Arena out of memory"));
+  arena->buffer_next = (byte *)(ptr + size);
+  return rawptr(ptr);
+}
+#define arena_alloc_type(arena, T)         ((T *)arena_alloc_size(arena, sizeof(T), alignof(T) - 1))
+#define arena_alloc_array(arena, T, count) ((T *)arena_alloc_size(arena, sizeof(T) * (count), alignof(T) - 1))
+/* NOTE: `with_arena(arena) {...}` frees everything allocated inside it, don't `return` out of it */
+#define arena_mark(arena)         ((arena)->buffer_next)
+#define arena_reset(arena, mark)  ((arena)->buffer_next = (mark))
+#define with_arena(arena)         with_arena_impl(__COUNTER__, arena)
+#define with_arena_impl(C, arena) with(byte *VAR(arena_mark, C) = arena_mark(arena), arena_reset(arena, VAR(arena_mark, C)))
+
 // ring buffer
 STRUCT(RingBuffer) {
   iptr buffer;
@@ -239,7 +269,7 @@ rawptr alloc_size(usize size, usize align_mask) {
   return rawptr(ptr);
 }
 #define alloc_type(T)         ((T *)alloc_size(sizeof(T), alignof(T) - 1))
-#define alloc_array(T, count) ((T *)alloc_size(sizeof(T) * count, alignof(T) - 1))
+#define alloc_array(T, count) ((T *)alloc_size(sizeof(T) * (count), alignof(T) - 1))
 
 #define free_ptr(ptr) free_size(ptr, alignof(*ptr) - 1)
 void free_size(void *ptr, usize align_mask) {
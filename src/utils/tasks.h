@@ -0,0 +1,136 @@
+#pragma once
+#include "builtin.h"
+#include "mem.h"
+#include "threads.h"
+
+// params
+#ifndef TASK_DEQUE_SIZE
+  #define TASK_DEQUE_SIZE 4096
+#endif
+ASSERT_POWER_OF_TWO(TASK_DEQUE_SIZE);
+
+// deque
+typedef void TaskProc(Thread t, rawptr data);
+STRUCT(Task) {
+  TaskProc *proc;
+  rawptr data;
+};
+/* NOTE: Chase-Lev deque, the owner pushes and pops at the bottom, while other threads steal from the top */
+STRUCT_ALIGNED(TaskDeque, ARCH_MAX_CACHE_LINE_SIZE) {
+  isize top;
+  alignto(ARCH_MAX_CACHE_LINE_SIZE) isize bottom;
+  alignto(ARCH_MAX_CACHE_LINE_SIZE) Task tasks[TASK_DEQUE_SIZE];
+};
+void _task_deque_push(TaskDeque *deque, Task task) {
+  // NOTE: wait-free population oblivious, but crash on overrun
+  isize bottom = volatile_load(&deque->bottom);
+  isize top = atomic_load(&deque->top);
+  assert2(bottom - top < TASK_DEQUE_SIZE, string("TaskDeque is full"));
+  deque->tasks[bottom & (TASK_DEQUE_SIZE - 1)] = task;
+  atomic_store(&deque->bottom, bottom + 1);
+}
+bool _task_deque_pop(TaskDeque *deque, Task *task) {
+  // NOTE: wait-free population oblivious, only the owner can pop
+  isize bottom = volatile_load(&deque->bottom) - 1;
+  atomic_store(&deque->bottom, bottom);
+  isize top = atomic_load(&deque->top);
+  if (top > bottom) {
+    atomic_store(&deque->bottom, bottom + 1);
+    return false;
+  }
+  *task = deque->tasks[bottom & (TASK_DEQUE_SIZE - 1)];
+  if (expect_near(top != bottom)) return true;
+  /* NOTE: last task, race the thieves for it */
+  bool is_ours = atomic_compare_exchange(&deque->top, &top, top + 1);
+  atomic_store(&deque->bottom, bottom + 1);
+  return is_ours;
+}
+bool _task_deque_steal(TaskDeque *deque, Task *task) {
+  // NOTE: lock-free
+  isize top = atomic_load(&deque->top);
+  isize bottom = atomic_load(&deque->bottom);
+  if (top >= bottom) return false;
+  /* NOTE: the owner may overwrite this slot after we read it, but then the compare_exchange fails */
+  *task = deque->tasks[top & (TASK_DEQUE_SIZE - 1)];
+  return atomic_compare_exchange(&deque->top, &top, top + 1);
+}
+
+// scheduler
+STRUCT(TaskScheduler) {
+  TaskDeque *deques;
+  /* NOTE: spawned, but not yet finished tasks */
+  u32 pending_count;
+  u32 sleeping_count;
+  u32 wake_counter;
+};
+global TaskScheduler global_tasks;
+
+/* NOTE: call this from every thread in the group before using the scheduler */
+void task_scheduler_init(Thread t) {
+  if (single_core(t)) {
+    u32 deque_count = max(global_threads.logical_core_count, 1);
+    TaskDeque *deques = alloc_array(TaskDeque, deque_count);
+    for (u32 i = 0; i < deque_count; i++) {
+      deques[i].top = 0;
+      deques[i].bottom = 0;
+    }
+    global_tasks = (TaskScheduler){deques, 0, 0, 0};
+  }
+  barrier(t);
+}
+void _task_wake_sleepers() {
+  /* NOTE: sleepers bump `sleeping_count` before rechecking, so either they see our change or we see them */
+  if (expect_far(atomic_load(&global_tasks.sleeping_count) != 0)) {
+    atomic_add_fetch(&global_tasks.wake_counter, 1);
+    wake_all_on_address(&global_tasks.wake_counter);
+  }
+}
+/* NOTE: push a task onto our own deque, can be called from inside a task */
+void task_spawn(Thread t, TaskProc *proc, rawptr data) {
+  atomic_add_fetch(&global_tasks.pending_count, 1);
+  _task_deque_push(&global_tasks.deques[t], (Task){proc, data});
+  _task_wake_sleepers();
+}
+void _task_run(Thread t, Task task) {
+  task.proc(t, task.data);
+  if (expect_far(atomic_sub_fetch(&global_tasks.pending_count, 1) == 0)) {
+    _task_wake_sleepers();
+  }
+}
+bool _task_steal_any(Thread t, Task *task) {
+  Thread threads_start = global_threads.thread_infos[t].threads_start;
+  Thread threads_end = global_threads.thread_infos[t].threads_end;
+  /* NOTE: start with our neighbour, so thieves don't all hit the same deque */
+  for (Thread i = t + 1; i < threads_end; i++) {
+    if (_task_deque_steal(&global_tasks.deques[i], task)) return true;
+  }
+  for (Thread i = threads_start; i < t; i++) {
+    if (_task_deque_steal(&global_tasks.deques[i], task)) return true;
+  }
+  return false;
+}
+/* NOTE: call this from every thread in the group, after spawning the initial tasks,
+  returns once all tasks (including the ones spawned by tasks) have finished */
+void task_scheduler_run(Thread t) {
+  barrier(t); /* NOTE: make sure the initial tasks have been spawned */
+  TaskDeque *deque = &global_tasks.deques[t];
+  while (true) {
+    Task task;
+    if (expect_near(_task_deque_pop(deque, &task) || _task_steal_any(t, &task))) {
+      _task_run(t, task);
+      continue;
+    }
+    // sleep
+    atomic_add_fetch(&global_tasks.sleeping_count, 1);
+    u32 wake_counter = atomic_load(&global_tasks.wake_counter);
+    bool is_done = atomic_load(&global_tasks.pending_count) == 0;
+    if (expect_near(!is_done && !_task_steal_any(t, &task))) {
+      wait_on_address(&global_tasks.wake_counter, wake_counter);
+      atomic_sub_fetch(&global_tasks.sleeping_count, 1);
+      continue;
+    }
+    atomic_sub_fetch(&global_tasks.sleeping_count, 1);
+    if (is_done) break;
+    _task_run(t, task);
+  }
+}
@@ -4,29 +4,74 @@
 #include "mem.h"
 #include "threads.h"
 
-STRUCT(TestGroup) {
-  string name;
+// params
+/* NOTE: thread 0 only prints progress every `TEST_PROGRESS_INTERVAL` checks */
+#define TEST_PROGRESS_INTERVAL 4096
+ASSERT_POWER_OF_TWO(TEST_PROGRESS_INTERVAL);
+
+/* NOTE: each thread counts into its own cache line, so check() never contends with other threads */
+STRUCT_ALIGNED(TestCounter, ARCH_MAX_CACHE_LINE_SIZE) {
   u64 test_count;
   u64 fail_count;
 };
+/* NOTE: groups are never freed, the general allocator can't reclaim memory yet (see reclaim_memory()),
+  and a test run only makes a handful of them */
+STRUCT(TestGroup) {
+  string name;
+  u32 counter_count;
+  TestCounter counters[] flexible(counter_count);
+};
+/* NOTE: allocate on the single_core() thread, since barrier_scatter() sends from the last thread that won single_core() */
 bool nonnull_(2) test_group(Thread t, TestGroup **group, string name, Thread thread_count) {
-  if (expect_near(t == 0)) {
-    *group = arena_alloc(&global_arena, TestGroup);
-    **group = (TestGroup){.name = name};
+  if (single_core(t)) {
+    u32 counter_count = max(global_threads.logical_core_count, 1);
+    *group = (TestGroup *)alloc_size(sizeof(TestGroup) + sizeof(TestCounter) * counter_count, alignof(TestGroup) - 1);
+    (*group)->name = name;
+    (*group)->counter_count = counter_count;
+    for (u32 i = 0; i < counter_count; i++) {
+      (*group)->counters[i] = (TestCounter){};
+    }
   }
   barrier_scatter(t, group);
   return thread_count == 0 || t < thread_count;
 }
+/* NOTE: other threads are still writing their counters, so this is only approximate */
+void test_progress(TestGroup *group) {
+  u64 test_count = 0;
+  u64 fail_count = 0;
+  for (u32 i = 0; i < group->counter_count; i++) {
+    test_count += volatile_load(&group->counters[i].test_count);
+    fail_count += volatile_load(&group->counters[i].fail_count);
+  }
+  u64 pass_count = test_count - fail_count;
+  printf(DELETE_LINE "  %: %/%", string, group->name, u64, pass_count, u64, test_count);
+}
 void test_summary(Thread t, TestGroup *group) {
   barrier(t); /* NOTE: wait for writes */
   if (expect_near(t == 0)) {
-    u64 test_count = group->test_count;
-    u64 pass_count = test_count - group->fail_count;
-    printf3(string(DELETE_LINE "   %: %/% tests passed\n"), string, group->name, u64, pass_count, u64, test_count);
+    u64 test_count = 0;
+    u64 fail_count = 0;
+    for (u32 i = 0; i < group->counter_count; i++) {
+      test_count += group->counters[i].test_count;
+      fail_count += group->counters[i].fail_count;
+    }
+    u64 pass_count = test_count - fail_count;
+    printf(DELETE_LINE "   %: %/% tests passed\n", string, group->name, u64, pass_count, u64, test_count);
   }
   barrier(t); /* NOTE: wait for reads */
 }
 
+// random
+/* NOTE: xorshift64, so that failures are reproducible */
+u64 test_random(u64 *state) {
+  u64 x = *state;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  *state = x;
+  return x;
+}
+
 // #define Test(t1, t2) Test_##t1##_##t2
 #define Test(t1, t2) Test
 #define TEST(t1, t2)     \
@@ -35,15 +80,16 @@ void test_summary(Thread t, TestGroup *group) {
     t2 out;              \
   }
 #define check(thread, group, condition, t1, v1)         check_impl(__COUNTER__, thread, group, condition, t1, v1)
-#define check_impl(C, thread, group, condition, t1, v1) ({                                                 \
-  u64 VAR(test_count, C) = atomic_add_fetch(&group->test_count, 1);                                        \
-  if (expect_near(t == 0)) {                                                                               \
-    u64 VAR(pass_count, C) = VAR(test_count, C) - group->fail_count;                                       \
-    printf(DELETE_LINE "  %: %/%", string, group->name, u64, VAR(pass_count, C), u64, VAR(test_count, C)); \
-  }                                                                                                        \
-  if (expect_far(!(condition))) {                                                                          \
-    u64 fail_count = atomic_add_fetch(&group->fail_count, 1);                                              \
-    printf(DELETE_LINE "  %: test failed for % (%)\n", string, group->name, hex, v1, t1, v1);              \
-    abort();                                                                                               \
-  }                                                                                                        \
+#define check_impl(C, thread, group, condition, t1, v1) ({                                                    \
+  TestCounter *VAR(counter, C) = &group->counters[thread];                                                    \
+  u64 VAR(test_count, C) = VAR(counter, C)->test_count + 1;                                                   \
+  volatile_store(&VAR(counter, C)->test_count, VAR(test_count, C));                                           \
+  if (expect_far(thread == 0 && (VAR(test_count, C) & (TEST_PROGRESS_INTERVAL - 1)) == 0)) {                  \
+    test_progress(group);                                                                                     \
+  }                                                                                                           \
+  if (expect_far(!(condition))) {                                                                             \
+    volatile_store(&VAR(counter, C)->fail_count, VAR(counter, C)->fail_count + 1);                            \
+    printf(DELETE_LINE "  %: test failed for % (%)\n", string, group->name, hex, v1, t1, v1);                 \
+    abort();                                                                                                  \
+  }                                                                                                           \
 })
@@ -2,6 +2,12 @@
 #include "builtin.h"
 #include "os.h"
 
+// params
+/* NOTE: how many times barriers poll before going to sleep, `cpu_relax()` takes ~10-150 cycles depending on the CPU */
+#ifndef BARRIER_SPIN_COUNT
+  #define BARRIER_SPIN_COUNT 1024
+#endif
+
 /* NOTE:
     BLOCKING - one thread can block many other threads (impacts throughput)
   STARVATION - one thread can be blocked indefinitely (impacts latency)
@@ -123,7 +129,7 @@ isize futex_wake(u32 *address, u32 count_to_wake) {
 // shared data
 DISTINCT(u32, Thread);
 #define Thread(x) ((Thread)(x))
-STRUCT_ALIGNED(ThreadInfo, 32) {
+STRUCT_ALIGNED(ThreadInfo, 64) {
   /* NOTE: barriers must be u32 on linux... */
   Thread threads_start;
   Thread threads_end;
@@ -134,9 +140,11 @@ STRUCT_ALIGNED(ThreadInfo, 32) {
   /* NOTE: alternate between [counter, thread_count] and [thread_count, counter] */
   u32 join_barrier;
   u32 join_barrier_counter;
+  /* NOTE: next chunk to claim in parallel_for() */
+  u32 parallel_for_counter;
 };
-ASSERT(sizeof(ThreadInfo) == 32);
-ASSERT(alignof(ThreadInfo) == 32);
+ASSERT(sizeof(ThreadInfo) == 64);
+ASSERT(alignof(ThreadInfo) == 64);
 STRUCT(Threads) {
   ThreadInfo *thread_infos;
   u64 *values;
@@ -190,6 +198,14 @@ void wake_all_on_address(u32 *address) {
   assert(false);
 #endif
 }
+/* NOTE: barrier phases are often only a few microseconds long, so spin for a bit before paying for a syscall */
+void _barrier_wait(u32 *address, u32 while_value) {
+  for (u32 i = 0; i < BARRIER_SPIN_COUNT; i++) {
+    if (expect_far(atomic_load(address) != while_value)) return;
+    cpu_relax();
+  }
+  wait_on_address(address, while_value);
+}
 /* wait until all threads enter this barrier() */
 void barrier(Thread t) {
   u32 threads_start = global_threads.thread_infos[t].threads_start;
@@ -201,10 +217,11 @@ void barrier(Thread t) {
   u32 barrier_stop = barrier + thread_count;
   u32 barrier_counter = atomic_add_fetch(&shared_data->barrier_counter, 1);
   if (expect_near(barrier_counter != barrier_stop)) {
-    wait_on_address(&shared_data->barrier, barrier);
+    _barrier_wait(&shared_data->barrier, barrier);
   } else {
     /* NOTE: reset counters in case we have a non-power-of-two number of threads */
     shared_data->is_first_counter = 0;
+    shared_data->parallel_for_counter = 0;
     atomic_store(&shared_data->barrier, barrier_stop);
     wake_all_on_address(&shared_data->barrier);
   }
@@ -244,6 +261,35 @@ u64 *barrier_gather_impl(Thread t, u64 value) {
   return global_threads.values;
 }
 
+// parallel for
+/* NOTE: `parallel_for(t, i, begin, end, grain) {...}` runs the body for each `i` in `[begin, end)` exactly once across the group,
+  threads claim `grain` items at a time, so slow items don't leave the other threads waiting,
+  all threads in the group must call it, it ends with a barrier(), and you can't `break` out of it,
+  the body must not call group-wide functions (barrier(), single_core(), barrier_scatter(), barrier_gather(), parallel_for()),
+  since threads run a different number of chunks, and a barrier() would reset `parallel_for_counter`, do those between loops instead */
+#define parallel_for(t, i, begin, end, grain) parallel_for_impl(__COUNTER__, t, i, begin, end, grain)
+#define parallel_for_impl(C, t, i, begin, end, grain)                                                                   \
+  for (iptr VAR(pf_begin, C) = (begin), VAR(pf_end, C) = (end), VAR(pf_grain, C) = (grain),                             \
+            VAR(pf_barrier, C) = _parallel_for_barrier(t),                                                              \
+            VAR(pf_chunk, C) = _parallel_for_claim(t, VAR(pf_begin, C), VAR(pf_grain, C), VAR(pf_barrier, C));          \
+       VAR(pf_chunk, C) < VAR(pf_end, C) || (barrier(t), false);                                                        \
+       VAR(pf_chunk, C) = _parallel_for_claim(t, VAR(pf_begin, C), VAR(pf_grain, C), VAR(pf_barrier, C)))               \
+    for (iptr i = VAR(pf_chunk, C), VAR(pf_chunk_end, C) = min(VAR(pf_chunk, C) + VAR(pf_grain, C), VAR(pf_end, C)); \
+         i < VAR(pf_chunk_end, C); i++)
+/* NOTE: `barrier` only changes once every thread reaches the barrier() at the end of the loop, so every thread reads the same value */
+iptr _parallel_for_barrier(Thread t) {
+  Thread threads_start = global_threads.thread_infos[t].threads_start;
+  return iptr(atomic_load(&global_threads.thread_infos[threads_start].barrier));
+}
+iptr _parallel_for_claim(Thread t, iptr begin, iptr grain, iptr barrier_value) {
+  assert(grain > 0); /* NOTE: `grain == 0` would claim `begin` forever */
+  Thread threads_start = global_threads.thread_infos[t].threads_start;
+  ThreadInfo *shared_data = &global_threads.thread_infos[threads_start];
+  assert2(atomic_load(&shared_data->barrier) == u32(barrier_value), string("barrier() inside parallel_for()"));
+  u32 chunk = atomic_fetch_add(&shared_data->parallel_for_counter, 1);
+  return begin + iptr(chunk) * grain;
+}
+
 // split/join threads
 bool barrier_split_threads(Thread t, u32 n) {
   // inline barrier() + modify threads
@@ -258,7 +304,7 @@ bool barrier_split_threads(Thread t, u32 n) {
   u32 barrier_stop = barrier + thread_count;
   u32 barrier_counter = atomic_add_fetch(&shared_data->barrier_counter, 1);
   if (expect_near(barrier_counter != barrier_stop)) {
-    wait_on_address(&shared_data->barrier, barrier);
+    _barrier_wait(&shared_data->barrier, barrier);
   } else {
     // modify threads
     for (Thread i = threads_start; i < threads_end; i++) {
@@ -272,8 +318,13 @@ bool barrier_split_threads(Thread t, u32 n) {
     /* NOTE: reset counters in case we have a non-power-of-two number of threads */
     shared_data->is_first_counter = 0;
     split_data->is_first_counter = 0;
+    shared_data->parallel_for_counter = 0;
+    split_data->parallel_for_counter = 0;
+    /* NOTE: the new group starts with a finished barrier */
+    split_data->barrier_counter = barrier_stop;
+    split_data->barrier = barrier_stop;
     // -modify threads
-    atomic_store(&split_data->barrier, barrier_stop);
+    atomic_store(&shared_data->barrier, barrier_stop);
     wake_all_on_address(&shared_data->barrier);
   }
   return t < threads_split;
@@ -288,7 +339,7 @@ void barrier_join_threads(Thread t, Thread threads_start, Thread threads_end) {
   u32 barrier_stop = barrier + thread_count;
   u32 barrier_counter = atomic_add_fetch(&shared_data->join_barrier_counter, 1);
   if (expect_near(barrier_counter != barrier_stop)) {
-    wait_on_address(&shared_data->join_barrier, barrier);
+    _barrier_wait(&shared_data->join_barrier, barrier);
   } else {
     // modify threads
     for (Thread i = threads_start; i < threads_end; i++) {
@@ -297,6 +348,7 @@ void barrier_join_threads(Thread t, Thread threads_start, Thread threads_end) {
       thread_data->threads_end = threads_end;
     }
     shared_data->is_first_counter = 0;
+    shared_data->parallel_for_counter = 0;
     shared_data->was_first_thread = threads_start;
     // -modify threads
     atomic_store(&shared_data->join_barrier, barrier_stop);